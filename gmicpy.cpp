@@ -5,10 +5,52 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "structmember.h"
 
+#include <sys/stat.h>
+
+#if cimg_OS == 1
+#include <sys/resource.h>
+#endif
+#if defined(__APPLE__)
+#include <malloc/malloc.h>
+#define gmicpy_malloc_size(pointer) malloc_size(pointer)
+#elif defined(__FreeBSD__)
+#include <malloc_np.h>
+#define gmicpy_malloc_size(pointer) malloc_usable_size(pointer)
+#elif defined(__linux__) || defined(_WIN32)
+#include <malloc.h>
+#ifdef _WIN32
+#define gmicpy_malloc_size(pointer) _msize(pointer)
+#else
+#define gmicpy_malloc_size(pointer) malloc_usable_size(pointer)
+#endif
+#endif
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GMICPY_SIMD_SSE
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define GMICPY_SIMD_NEON
+#endif
+
 using namespace std;
 
 //------- G'MIC-PY MACROS ----------//
@@ -24,6 +66,7 @@ using namespace std;
 //------- G'MIC MAIN TYPES ----------//
 
 static PyObject *GmicException;
+static PyObject *GmicAborted;
 
 static PyTypeObject PyGmicImageType = {
     PyVarObject_HEAD_INIT(NULL, 0) "gmic.GmicImage" /* tp_name */
@@ -33,8 +76,27 @@ static PyTypeObject PyGmicType = {
     PyVarObject_HEAD_INIT(NULL, 0) "gmic.Gmic" /* tp_name */
 };
 
+static PyTypeObject PyGmicPoolType = {
+    PyVarObject_HEAD_INIT(NULL, 0) "gmic.GmicPool" /* tp_name */
+};
+
+static PyTypeObject PyGmicStreamType = {
+    PyVarObject_HEAD_INIT(NULL, 0) "gmic.GmicStream" /* tp_name */
+};
+
+static PyTypeObject PyGmicSessionType = {
+    PyVarObject_HEAD_INIT(NULL, 0) "gmic.GmicSession" /* tp_name */
+};
+
 typedef struct {
     PyObject_HEAD gmic_image<T> *_gmic_image;  // G'MIC library's Gmic Image
+    // Number of live buffer protocol exports, during which the buffer must
+    // neither move nor be resized
+    Py_ssize_t _exports;
+    // Buffer of another Python object (eg. a numpy.ndarray) that
+    // _gmic_image shares its pixels with, if any. Its obj field is NULL
+    // for images owning their pixels.
+    Py_buffer _owner_buffer;
 } PyGmicImage;
 
 typedef struct {
@@ -42,8 +104,67 @@ typedef struct {
         // Using a pointer here and PyGmic_new()-time instantiation fixes a
         // crash with empty G'MIC command-set.
         gmic *_gmic;  // G'MIC library's interpreter instance
+    // Serializes runs on the same interpreter, since runs happen without the
+    // GIL held.
+    PyThread_type_lock _lock;
+    // Extra warm gmic.Gmic instances for Gmic.run_batch() worker threads,
+    // created on first use
+    PyObject *_batch_interpreters;
+    // G'MIC's abort flag for the ongoing run, raised by Gmic.abort() or
+    // on timeout
+    std::atomic<bool> _is_abort;
+    // Number of runs entered so far, and number of the last run entered
+    // before the latest Gmic.abort() call: runs up to it are aborted, even
+    // if they were still waiting for the lock
+    std::atomic<unsigned long> _entered_runs;
+    std::atomic<unsigned long> _aborted_runs;
+    // G'MIC's progress of the ongoing or last run, in [0,100] or -1 if
+    // unknown
+    std::atomic<float> _progress;
+    // Default memory budget of runs in bytes, or 0 for no limit
+    size_t _max_memory;
 } PyGmic;
 
+// G'MIC polls and updates these flags through plain pointers
+static_assert(sizeof(std::atomic<bool>) == sizeof(bool) &&
+                  sizeof(std::atomic<float>) == sizeof(float),
+              "G'MIC's abort and progress flags must be atomic-compatible");
+
+typedef struct {
+    PyObject_HEAD
+        // Warm gmic.Gmic instances, created once for the pool's lifetime
+        PyObject *_interpreters;
+    PyObject *_idle_interpreters;  // List of gmic.Gmic instances not running
+    // concurrent.futures.ThreadPoolExecutor with one worker per interpreter
+    PyObject *_executor;
+} PyGmicPool;
+
+typedef struct {
+    PyObject_HEAD
+        // Interpreter running the frames, on the stream's worker thread
+        PyGmic *_interpreter;
+    PyObject *_frames;   // Iterator of input frames
+    bool _reuse_output;  // Whether to yield the same '_outputs' each time
+    PyObject *_outputs;  // List of GmicImage results, if reused
+    // Frame conversion error, raised at the call after the one it happened in
+    PyObject *_error_type;
+    PyObject *_error_value;
+    PyObject *_error_traceback;
+    struct gmicpy_stream_state *_state;
+} PyGmicStream;
+
+typedef struct {
+    PyObject_HEAD
+        // Interpreter running the session's commands
+        PyGmic *_interpreter;
+    // Serializes accesses to the session's images, which runs make without
+    // the GIL held
+    PyThread_type_lock _lock;
+    gmic_list<T> *_images;  // Images resident across runs
+    // Names of the resident images, as many as images
+    gmic_list<char> *_image_names;
+} PyGmicSession;
+
 //------- G'MIC INTERPRETER INSTANCE BINDING ----------//
 
 static PyObject *
@@ -54,1420 +175,5838 @@ PyGmic_repr(PyGmic *self)
         Py_TYPE(self)->tp_name, self, self->_gmic);
 }
 
-/* Copy a GmicImage's contents into a gmic_list at a given position. Run this
- * typically before a gmic.run(). */
-static void
-swap_gmic_image_into_gmic_list(PyGmicImage *image, gmic_list<T> &images,
-                               int position)
+// Seconds between two progress reports of Gmic.run()'s 'progress' parameter
+#define GMIC_PY_PROGRESS_INTERVAL 0.1
+
+/* Optional controls of a G'MIC run, as given to Gmic.run() and friends. */
+struct gmicpy_run_options {
+    double timeout;  // Seconds before aborting the run, or 0 for no limit
+    // Bytes of memory the run may use before being aborted, or 0 for no
+    // limit
+    size_t max_memory;
+    // Callable receiving the run's progress periodically, or NULL (borrowed)
+    PyObject *progress_callback;
+    // Writable float32 buffer receiving the run's progress periodically,
+    // obj is NULL if none
+    Py_buffer progress_view;
+
+    gmicpy_run_options()
+        : timeout(0),
+          max_memory(0),
+          progress_callback(NULL)
+    {
+        progress_view.obj = NULL;
+        progress_view.buf = NULL;
+    }
+};
+
+/* Read a 'max_memory' parameter, in bytes, defaulting to default_value if
+ * NULL or None. Returns false with a Python exception set on failure. */
+static bool
+gmicpy_parse_max_memory(PyObject *input_max_memory, size_t default_value,
+                        size_t *max_memory)
 {
-    images[position].assign(
-        image->_gmic_image->_width, image->_gmic_image->_height,
-        image->_gmic_image->_depth, image->_gmic_image->_spectrum);
-    images[position]._width = image->_gmic_image->_width;
-    images[position]._height = image->_gmic_image->_height;
-    images[position]._depth = image->_gmic_image->_depth;
-    images[position]._spectrum = image->_gmic_image->_spectrum;
-    memcpy(images[position]._data, image->_gmic_image->_data,
-           image->_gmic_image->size() * sizeof(T));
-    images[position]._is_shared = image->_gmic_image->_is_shared;
+    Py_ssize_t value = 0;
+
+    if (input_max_memory == NULL || input_max_memory == Py_None) {
+        *max_memory = default_value;
+        return true;
+    }
+    value = PyNumber_AsSsize_t(input_max_memory, PyExc_OverflowError);
+    if (value == -1 && PyErr_Occurred()) {
+        return false;
+    }
+    if (value < 0) {
+        PyErr_Format(PyExc_ValueError,
+                     "'max_memory' parameter must be a positive number of "
+                     "bytes or 0 (for no limit), got %zd.",
+                     value);
+        return false;
+    }
+    *max_memory = (size_t)value;
+
+    return true;
 }
 
-/* Copy a GmicList's image at given index into an external GmicImage. Run this
- * typically after gmic.run(). */
-void
-swap_gmic_list_item_into_gmic_image(gmic_list<T> &images, int position,
-                                    PyGmicImage *image)
+/* Fill the progress reporting options from Gmic.run()'s 'progress'
+ * parameter. Returns false with a Python exception set on failure. */
+static bool
+gmicpy_run_options_set_progress(gmicpy_run_options *options,
+                                PyObject *progress)
 {
-    // Put back the possibly modified reallocated image buffer into the
-    // original external GmicImage Back up the image data into the original
-    // external image before it gets freed
-    swap(image->_gmic_image->_data, images[position]._data);
-    image->_gmic_image->_width = images[position]._width;
-    image->_gmic_image->_height = images[position]._height;
-    image->_gmic_image->_depth = images[position]._depth;
-    image->_gmic_image->_spectrum = images[position]._spectrum;
-    image->_gmic_image->_is_shared = images[position]._is_shared;
-    // Prevent freeing the data buffer's pointer now copied into the external
-    // image
-    images[position]._data = 0;
-}
+    if (progress == NULL || progress == Py_None) {
+        return true;
+    }
+    if (PyCallable_Check(progress)) {
+        options->progress_callback = progress;
+        return true;
+    }
+    if (PyObject_CheckBuffer(progress) &&
+        PyObject_GetBuffer(progress, &options->progress_view,
+                           PyBUF_WRITABLE | PyBUF_FORMAT) == 0) {
+        const char *format = options->progress_view.format;
+        // Native byte order float32 items only
+        if (format != NULL &&
+            (strcmp(format, "f") == 0 || strcmp(format, "@f") == 0 ||
+             strcmp(format, "=f") == 0) &&
+            options->progress_view.len >= (Py_ssize_t)sizeof(float)) {
+            return true;
+        }
+        PyBuffer_Release(&options->progress_view);
+        options->progress_view.obj = NULL;
+        options->progress_view.buf = NULL;
+    }
+    PyErr_Clear();
+    PyErr_Format(PyExc_TypeError,
+                 "'%.50s' 'progress' parameter must be a callable or a "
+                 "writable float32 buffer (eg. a numpy.float32 array).",
+                 Py_TYPE(progress)->tp_name);
 
-#ifdef gmic_py_jupyter_ipython_display
+    return false;
+}
 
-// Cross-platform way to have a temp directory string, through Python
-const char *
-get_temp_dir()
+static void
+gmicpy_run_options_clear(gmicpy_run_options *options)
 {
-    PyObject *module = NULL;
-    PyObject *pystr = NULL;
-    module = PyImport_ImportModule("tempfile");
-    pystr = PyObject_CallMethod(module, "gettempdir", NULL);
-    Py_XDECREF(pystr);
-    Py_XDECREF(module);
-    return PyUnicode_AsUTF8(pystr);
+    if (options->progress_view.obj != NULL) {
+        PyBuffer_Release(&options->progress_view);
+        options->progress_view.obj = NULL;
+        options->progress_view.buf = NULL;
+    }
 }
 
-// Cross-platform way to have a unique id string, through Python
-const char *
-get_uuid()
+/* What happened during a G'MIC run, besides its results. */
+struct gmicpy_run_report {
+    std::string error_message;  // Set if the run does not complete
+    // Exception raised by the progress callback, which aborts the run
+    PyObject *callback_error_type;
+    PyObject *callback_error_value;
+    PyObject *callback_error_traceback;
+    double lock_wait_seconds;  // Time spent waiting for the instance lock
+    double run_seconds;        // Time spent in gmic::run()
+    bool has_monitor_thread;   // Whether a monitor thread watched the run
+    // Peak of the bytes allocated by the run's own thread, less those it
+    // freed
+    size_t peak_memory_bytes;
+
+    gmicpy_run_report()
+        : callback_error_type(NULL),
+          callback_error_value(NULL),
+          callback_error_traceback(NULL),
+          lock_wait_seconds(0),
+          run_seconds(0),
+          has_monitor_thread(false),
+          peak_memory_bytes(0)
+    {
+    }
+};
+
+typedef std::chrono::steady_clock gmicpy_clock;
+
+static double
+gmicpy_seconds_between(gmicpy_clock::time_point start,
+                       gmicpy_clock::time_point end)
 {
-    PyObject *module = NULL;
-    PyObject *pystr = NULL;
-    module = PyImport_ImportModule("uuid");
-    // Using a time-sortable uuid generator for file names
-    // See https://stackoverflow.com/a/63970430/420684
-    pystr = PyObject_Str(PyObject_CallMethod(module, "uuid1", "II", 0, 0));
-    Py_XDECREF(pystr);
-    Py_XDECREF(module);
-    return PyUnicode_AsUTF8(pystr);
+    return std::chrono::duration<double>(end - start).count();
 }
 
-// You must free the result if result is non-NULL.
-// Modified from https://stackoverflow.com/a/779960/420684
-// Returns: a tuple of (adapted_gmic_command_string, ["a list of
-// fi*le*","glob*","strings*"])
-PyObject *
-gmic_py_str_replace_display_to_output(char *orig, char *extension)
+static gmicpy_clock::time_point
+gmicpy_time_after(gmicpy_clock::time_point start, double seconds)
 {
-    PyObject *pyresult = NULL;  // A (result_commands_line, (list,of,filename,
-                                // glob,strings)) 2-elements tuple
-    PyObject *pyglobs = NULL;   // A (result_commands_line, (list,of,filename,
-                                // glob,strings)) 2-elements tuple
-    char rep[] = " display";    // The string to seek and replace, ie. needle
-    char replacement_command[] =
-        " display output ";  // The string to seek and replace, ie. needle
-    char *result;            // the return string
-    char *ins;               // the next insert point
-    char *tmp;               // varies
-    int len_rep;             // length of rep (the string to remove)
-    int len_with;            // length of with (the string to replace rep with)
-    int len_front;           // distance between rep and end of last rep
-    int count;               // number of replacements
-    char with[512];          // replacement path
-    char with_globbed[512];  // replacement path with glob ending
+    return start + std::chrono::duration_cast<gmicpy_clock::duration>(
+                       std::chrono::duration<double>(seconds));
+}
 
-    with[0] = '\0';
-    with_globbed[0] = '\0';
-    pyglobs = PyList_New(0);
-    Py_INCREF(pyglobs);
+/* Memory charged to a G'MIC run: the arrays allocated by the thread running
+ * it (ie. CImg pixel buffers and image lists), less the ones it freed. Array
+ * allocations going over the run's budget fail with std::bad_alloc, which
+ * CImg turns into an error, and raise G'MIC's abort flag. Allocations of
+ * G'MIC's worker threads (OpenMP loops, 'parallel' command) are not charged. */
+struct gmicpy_memory_account {
+    size_t budget;          // 0 for no limit
+    long long bytes;        // May go below 0 when freeing the run's inputs
+    long long peak_bytes;
+    size_t refused_bytes;   // Size of the first allocation refused, or 0
+    long long refused_at_bytes;  // Bytes charged when it was refused
+    std::atomic<bool> *is_abort;
+
+    explicit gmicpy_memory_account(size_t max_memory,
+                                   std::atomic<bool> *abort_flag)
+        : budget(max_memory),
+          bytes(0),
+          peak_bytes(0),
+          refused_bytes(0),
+          refused_at_bytes(0),
+          is_abort(abort_flag)
+    {
+    }
+};
 
-    // sanity checks and initialization
-    if (!orig || !rep)
-        return NULL;
-    len_rep = strlen(rep);
-    if (len_rep == 0)
-        return NULL;  // empty rep causes infinite loop during count
+#ifdef gmicpy_malloc_size
+#define GMICPY_HAS_MEMORY_ACCOUNT
+#endif
 
-    // build a first uuid to detect fixed replacement string length
-    // 'with' becomes thus '/tmp/unique-id.png'
-    // 'with_globbed' becomes '/tmp/unique-id*.png'
-    strcat(with, replacement_command);
-    strcat(with, get_temp_dir());
-    strcat(with, "/");
-    strcat(with, get_uuid());
-    strcpy(with_globbed, with);
-    strcat(with_globbed, "*");
-    strcat(with, extension);
-    strcat(with_globbed, extension);
-    len_with = strlen(with);
+// Account of the run in progress in the current thread, or NULL
+static thread_local gmicpy_memory_account *gmicpy_thread_memory_account = NULL;
 
-    // count the number of replacements needed
-    ins = orig;
-    for (count = 0; (tmp = strstr(ins, rep)); ++count) {
-        ins = tmp + len_rep;
+#ifdef GMICPY_HAS_MEMORY_ACCOUNT
+/* Allocate an array for operator new[], charging it to the current thread's
+ * run if any. Returns NULL if out of memory or over budget. */
+static void *
+gmicpy_account_malloc(size_t size)
+{
+    gmicpy_memory_account *account = gmicpy_thread_memory_account;
+    void *pointer = NULL;
+
+    if (account != NULL && account->budget > 0 &&
+        account->bytes + (long long)size > (long long)account->budget) {
+        if (account->refused_bytes == 0) {
+            account->refused_bytes = size;
+            account->refused_at_bytes = account->bytes;
+        }
+        *account->is_abort = true;
+        return NULL;
+    }
+    pointer = malloc(size ? size : 1);
+    if (pointer != NULL && account != NULL) {
+        account->bytes += (long long)gmicpy_malloc_size(pointer);
+        account->peak_bytes = std::max(account->peak_bytes, account->bytes);
     }
 
-    tmp = result =
-        (char *)malloc(strlen(orig) + (len_with - len_rep) * count + 1);
-
-    if (!result)
-        return NULL;
+    return pointer;
+}
 
-    // first time through the loop, all the variable are set correctly
-    // from here on,
-    //    tmp points to the end of the result string
-    //    ins points to the next occurrence of rep in orig
-    //    orig points to the remainder of orig after "end of rep"
-    while (count--) {
-        PyList_Append(
-            pyglobs,
-            Py_BuildValue("s", with_globbed + strlen(replacement_command)));
-        ins = strstr(orig, rep);
+static void
+gmicpy_account_free(void *pointer)
+{
+    gmicpy_memory_account *account = gmicpy_thread_memory_account;
 
-        len_front = ins - orig;
-        tmp = strncpy(tmp, orig, len_front) + len_front;
-        tmp = strcpy(tmp, with) + len_with;
-        orig += len_front + len_rep;  // move to next "end of rep"
+    if (pointer == NULL) {
+        return;
+    }
+    if (account != NULL) {
+        account->bytes -= (long long)gmicpy_malloc_size(pointer);
+    }
+    free(pointer);
+}
 
-        // recompute a uuid file path for each replacement
-        with[0] = '\0';
-        with_globbed[0] = '\0';
-        strcat(with, replacement_command);
-        strcat(with, get_temp_dir());
-        strcat(with, "/");
-        strcat(with, get_uuid());
-        strcpy(with_globbed, with);
-        strcat(with_globbed, "*");
-        strcat(with, extension);
-        strcat(with_globbed, extension);
+/* Array allocations of this module and of the G'MIC library compiled into
+ * it, that is CImg's pixel buffers and image lists. They stay plain malloc()
+ * and free() calls as with the C++ runtime's own operators, so that arrays
+ * may still be freed by either. */
+void *
+operator new[](size_t size)
+{
+    void *pointer = gmicpy_account_malloc(size);
+    if (pointer == NULL) {
+        throw std::bad_alloc();
     }
-    strcpy(tmp, orig);
+    return pointer;
+}
 
-    pyresult = PyList_New(0);
-    PyList_Append(pyresult, Py_BuildValue("s", result));
-    PyList_Append(pyresult, pyglobs);
-    Py_DECREF(pyglobs);
+void *
+operator new[](size_t size, const std::nothrow_t &) noexcept
+{
+    return gmicpy_account_malloc(size);
+}
 
-    return pyresult;
+void
+operator delete[](void *pointer) noexcept
+{
+    gmicpy_account_free(pointer);
 }
 
-PyObject *
-gmic_py_display_with_matplotlib_or_ipython(PyObject *image_files_glob_strings)
+void
+operator delete[](void *pointer, const std::nothrow_t &) noexcept
 {
-    if (!PyList_Check(image_files_glob_strings)) {
-        PyErr_Format(GmicException, "input globs list is not a Python list");
+    gmicpy_account_free(pointer);
+}
+#endif
 
-        return NULL;
+/* Peak resident memory of the process so far, in bytes, or 0 if unknown. */
+static size_t
+gmicpy_peak_rss_bytes()
+{
+#if cimg_OS == 1
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0) {
+#ifdef __APPLE__
+        return (size_t)usage.ru_maxrss;  // Already in bytes
+#else
+        return (size_t)usage.ru_maxrss * 1024;
+#endif
     }
-    PyObject *ipython_display_module = NULL;
-    PyObject *matplotlib_pyplot_module = NULL;
-    PyObject *matplotlib_image_module = NULL;
-    PyObject *glob_module = NULL;
-    PyObject *image_glob_str = NULL;
-    PyObject *image_expanded_filenames = NULL;
-    PyObject *all_image_expanded_filenames = NULL;
-    PyObject *image = NULL;
-    PyObject *display_result = NULL;
-    unsigned int nb_subplots = 0;
-    int matplotlib_subplot_id = 1;
-    bool use_matplotlib = false;
-    bool use_ipython = false;
-    unsigned int i = 0;
-    unsigned int j = 0;
-    matplotlib_pyplot_module = PyImport_ImportModule("matplotlib.pyplot");
-    if (matplotlib_pyplot_module == NULL) {
-        use_matplotlib = false;
-        ipython_display_module = PyImport_ImportModule("IPython.core.display");
-        if (ipython_display_module == NULL) {
-            use_ipython = false;
-            PyErr_Clear();
-            PyErr_Format(GmicException,
-                         "Could not use matplotlib neither ipython to try to "
-                         "display images");
-            return NULL;
-        }
-        else {
-            PyErr_Clear();
-            use_ipython = true;
+#endif
+    return 0;
+}
+
+enum gmicpy_run_status {
+    GMICPY_RUN_DONE,
+    GMICPY_RUN_FAILED,     // G'MIC raised an error
+    GMICPY_RUN_ABORTED,    // Gmic.abort() was called meanwhile
+    GMICPY_RUN_TIMED_OUT,  // The run's timeout expired
+    GMICPY_RUN_OUT_OF_MEMORY,  // The run went over its memory budget
+};
+
+/* Hand the current progress of an interpreter's run over to the 'progress'
+ * run parameter. Called without the GIL held. */
+static void
+PyGmic_report_progress(PyGmic *self, const gmicpy_run_options &options,
+                       gmicpy_run_report &report)
+{
+    float progress = self->_progress;
+    PyGILState_STATE gil_state;
+    PyObject *callback_result = NULL;
+
+    if (options.progress_view.buf != NULL) {
+        *(float *)options.progress_view.buf = progress;
+    }
+    if (options.progress_callback != NULL &&
+        report.callback_error_type == NULL) {
+        gil_state = PyGILState_Ensure();
+        callback_result = PyObject_CallFunction(options.progress_callback,
+                                                "d", (double)progress);
+        if (callback_result == NULL) {
+            PyErr_Fetch(&report.callback_error_type,
+                        &report.callback_error_value,
+                        &report.callback_error_traceback);
+            self->_is_abort = true;
         }
+        Py_XDECREF(callback_result);
+        PyGILState_Release(gil_state);
     }
-    else {
-        use_matplotlib = true;
-        use_ipython = false;
-        matplotlib_image_module = PyImport_ImportModule("matplotlib.image");
+}
+
+/* Run the G'MIC interpreter on a gmic_list, once the GIL has been released
+ * by the caller, holding the instance lock. No C++ exception may leave
+ * here, and Python is only called back through PyGILState_Ensure(). Fills
+ * report.error_message if the run does not complete. */
+static gmicpy_run_status
+PyGmic_run_nogil_locked(PyGmic *self, const char *commands_line,
+                        gmic_list<T> &images, gmic_list<char> &image_names,
+                        const gmicpy_run_options &options,
+                        gmicpy_run_report &report)
+{
+    typedef gmicpy_clock clock;
+    gmicpy_run_status status = GMICPY_RUN_DONE;
+    clock::time_point lock_wait_start = clock::now();
+    clock::time_point run_start;
+    std::mutex monitor_mutex;
+    std::condition_variable monitor_condition;
+    std::thread monitor;
+    bool is_run_done = false;
+    bool has_timed_out = false;
+    bool has_progress = options.progress_callback != NULL ||
+                        options.progress_view.buf != NULL;
+    gmicpy_memory_account memory_account(options.max_memory,
+                                         &self->_is_abort);
+    char error_message[192];
+
+    unsigned long run_number = ++self->_entered_runs;
+
+    PyThread_acquire_lock(self->_lock, WAIT_LOCK);
+    run_start = clock::now();
+    report.lock_wait_seconds =
+        gmicpy_seconds_between(lock_wait_start, run_start);
+    // Clear the former run's abort flag, unless Gmic.abort() was called
+    // after this run was entered. Checked after clearing, so that an
+    // abort() call in between is never lost.
+    self->_is_abort = false;
+    if (run_number <= self->_aborted_runs) {
+        self->_is_abort = true;
+    }
+    self->_progress = -1;
+#ifndef GMICPY_HAS_MEMORY_ACCOUNT
+    if (options.max_memory > 0) {
+        PyThread_release_lock(self->_lock);
+        report.error_message =
+            "'max_memory' budgets are not supported on this platform.";
+        return GMICPY_RUN_FAILED;
     }
+#endif
 
-    all_image_expanded_filenames = PyList_New(0);
-    glob_module = PyImport_ImportModule("glob");
-    for (i = 0; i < PyList_Size(image_files_glob_strings); i++) {
-        // display(Image('image_path...', unconfined=True))
-        image_glob_str = PyList_GetItem(image_files_glob_strings, i);
-        image_expanded_filenames =
-            PyObject_CallMethod(glob_module, "glob", "O", image_glob_str);
-        for (j = 0; j < PyList_Size(image_expanded_filenames); j++) {
-            PyList_Append(all_image_expanded_filenames,
-                          PyList_GetItem(image_expanded_filenames, j));
+    // Watch the run from another thread: raise G'MIC's abort flag if it is
+    // still going on at timeout, and report its progress meanwhile
+    if (options.timeout > 0 || has_progress) {
+        try {
+            monitor = std::thread([&]() {
+                const clock::time_point deadline =
+                    gmicpy_time_after(run_start, options.timeout);
+                clock::time_point next_progress_report = gmicpy_time_after(
+                    run_start, GMIC_PY_PROGRESS_INTERVAL);
+                std::unique_lock<std::mutex> monitor_lock(monitor_mutex);
+                while (!is_run_done) {
+                    clock::time_point wake_up = clock::time_point::max();
+                    if (has_progress) {
+                        wake_up = std::min(wake_up, next_progress_report);
+                    }
+                    if (options.timeout > 0 && !has_timed_out) {
+                        wake_up = std::min(wake_up, deadline);
+                    }
+                    if (wake_up == clock::time_point::max()) {
+                        monitor_condition.wait(
+                            monitor_lock, [&]() { return is_run_done; });
+                        break;
+                    }
+                    if (monitor_condition.wait_until(
+                            monitor_lock, wake_up,
+                            [&]() { return is_run_done; })) {
+                        break;
+                    }
+                    clock::time_point now = clock::now();
+                    if (options.timeout > 0 && !has_timed_out &&
+                        now >= deadline) {
+                        has_timed_out = true;
+                        self->_is_abort = true;
+                    }
+                    if (has_progress && now >= next_progress_report) {
+                        monitor_lock.unlock();
+                        PyGmic_report_progress(self, options, report);
+                        monitor_lock.lock();
+                        next_progress_report = gmicpy_time_after(
+                            clock::now(), GMIC_PY_PROGRESS_INTERVAL);
+                    }
+                }
+            });
         }
+        catch (std::exception &e) {
+            PyThread_release_lock(self->_lock);
+            report.error_message = e.what();
+            return GMICPY_RUN_FAILED;
+        }
+        report.has_monitor_thread = true;
     }
-    // Sort files by unique ID otherwise they will be in some kind of mess,
+
+    // Charge the run's array allocations to it, in this thread only, so that
+    // runs in parallel are accounted for separately
+    gmicpy_thread_memory_account = &memory_account;
+    try {
+        self->_gmic->run(commands_line, images, image_names,
+                         reinterpret_cast<float *>(&self->_progress),
+                         reinterpret_cast<bool *>(&self->_is_abort));
+    }
+    catch (gmic_exception &e) {
+        status = GMICPY_RUN_FAILED;
+        report.error_message = e.what();
+    }
+    catch (std::exception &e) {
+        status = GMICPY_RUN_FAILED;
+        report.error_message = e.what();
+    }
+    gmicpy_thread_memory_account = NULL;
+    report.peak_memory_bytes = (size_t)memory_account.peak_bytes;
+
+    if (monitor.joinable()) {
+        {
+            std::lock_guard<std::mutex> monitor_lock(monitor_mutex);
+            is_run_done = true;
+        }
+        monitor_condition.notify_one();
+        monitor.join();
+    }
+    report.run_seconds = gmicpy_seconds_between(run_start, clock::now());
+    // Report the final progress too
+    if (has_progress) {
+        PyGmic_report_progress(self, options, report);
+    }
+
+    // An aborted run may end quietly as well as with an error
+    if (has_timed_out) {
+        status = GMICPY_RUN_TIMED_OUT;
+        snprintf(error_message, sizeof(error_message),
+                 "G'MIC run timed out after %g seconds.", options.timeout);
+        report.error_message = error_message;
+    }
+    else if (memory_account.refused_bytes > 0) {
+        status = GMICPY_RUN_OUT_OF_MEMORY;
+        snprintf(error_message, sizeof(error_message),
+                 "G'MIC run was aborted for allocating %zu more bytes of "
+                 "memory while using %lld, over its %zu bytes budget.",
+                 memory_account.refused_bytes, memory_account.refused_at_bytes,
+                 options.max_memory);
+        report.error_message = error_message;
+    }
+    else if (self->_is_abort) {
+        status = GMICPY_RUN_ABORTED;
+        report.error_message = "G'MIC run was aborted.";
+    }
+    PyThread_release_lock(self->_lock);
+
+    return status;
+}
+
+/* Python exception class matching a run which did not complete. Going over
+ * the memory budget is an error rather than a deliberate abort. */
+static PyObject *
+gmicpy_run_error_type(gmicpy_run_status status)
+{
+    return status == GMICPY_RUN_ABORTED || status == GMICPY_RUN_TIMED_OUT
+               ? GmicAborted
+               : GmicException;
+}
+
+/* Set the Python exception matching a run which did not complete. An error
+ * of the progress callback takes precedence. */
+static void
+gmicpy_set_run_error(gmicpy_run_status status, gmicpy_run_report &report)
+{
+    if (report.callback_error_type != NULL) {
+        PyErr_Restore(report.callback_error_type, report.callback_error_value,
+                      report.callback_error_traceback);
+        report.callback_error_type = NULL;
+        report.callback_error_value = NULL;
+        report.callback_error_traceback = NULL;
+        return;
+    }
+
+    PyErr_SetString(gmicpy_run_error_type(status),
+                    report.error_message.c_str());
+}
+
+/* Run the G'MIC interpreter on a gmic_list with the GIL released, so that
+ * other Python threads keep running while G'MIC works. The instance lock is
+ * taken once the GIL is released, so that two Python threads sharing a same
+ * gmic.Gmic object queue up instead of corrupting it (and cannot deadlock on
+ * the GIL). Returns false with a GmicException (or GmicAborted) set if the
+ * run does not complete. */
+static bool
+PyGmic_run_without_gil(PyGmic *self, const char *commands_line,
+                       gmic_list<T> &images, gmic_list<char> &image_names,
+                       const gmicpy_run_options &options,
+                       gmicpy_run_report &report)
+{
+    gmicpy_run_status status = GMICPY_RUN_DONE;
+
+    Py_BEGIN_ALLOW_THREADS
+    status = PyGmic_run_nogil_locked(self, commands_line, images,
+                                     image_names, options, report);
+    Py_END_ALLOW_THREADS
+
+    if (status != GMICPY_RUN_DONE || report.callback_error_type != NULL) {
+        gmicpy_set_run_error(status, report);
+        return false;
+    }
+
+    return true;
+}
+
+// Size of the blocks of pixels copied then summed while still in cache by
+// gmicpy_copy_pixels_with_checksum()
+#define GMICPY_CHECKSUM_BLOCK_BYTES (16 << 10)
+
+/* Checksum of pixels, telling whether a run wrote into an input buffer
+ * without keeping a copy of its former pixels. Four FNV-1a lanes over
+ * 64-bit words keep several multiplications in flight. Each step is a
+ * bijection of its lane, so changing a single word always changes the
+ * checksum. */
+struct gmicpy_checksum {
+    uint64_t lanes[4];
+
+    gmicpy_checksum()
+    {
+        for (int lane = 0; lane < 4; lane++) {
+            lanes[lane] = 0xcbf29ce484222325ULL + lane;
+        }
+    }
+
+    /* Add bytes to the checksum. All calls but the last one must have a
+     * length multiple of 32 bytes. */
+    void update(const unsigned char *bytes, size_t length)
+    {
+        uint64_t words[4];
+        size_t i = 0;
+
+        for (; i + 32 <= length; i += 32) {
+            memcpy(words, bytes + i, 32);
+            for (int lane = 0; lane < 4; lane++) {
+                lanes[lane] = (lanes[lane] ^ words[lane]) * 0x100000001b3ULL;
+            }
+        }
+        if (i < length) {
+            memset(words, 0, 32);
+            memcpy(words, bytes + i, length - i);
+            for (int lane = 0; lane < 4; lane++) {
+                lanes[lane] = (lanes[lane] ^ words[lane]) * 0x100000001b3ULL;
+            }
+        }
+    }
+
+    uint64_t digest() const
+    {
+        uint64_t digest = lanes[0];
+        for (int lane = 1; lane < 4; lane++) {
+            digest = (digest ^ lanes[lane]) * 0x100000001b3ULL;
+        }
+        return digest;
+    }
+};
+
+/* Checksum of an image's pixels. */
+static uint64_t
+gmicpy_pixels_checksum(const gmic_image<T> &image)
+{
+    gmicpy_checksum checksum;
+
+    checksum.update((const unsigned char *)image._data,
+                    image.size() * sizeof(T));
+    return checksum.digest();
+}
+
+/* Copy pixels and return their checksum, in a single pass over memory. */
+static uint64_t
+gmicpy_copy_pixels_with_checksum(T *destination, const T *source,
+                                 size_t count)
+{
+    gmicpy_checksum checksum;
+    const size_t length = count * sizeof(T);
+
+    for (size_t from = 0; from < length; from += GMICPY_CHECKSUM_BLOCK_BYTES) {
+        size_t block =
+            std::min((size_t)GMICPY_CHECKSUM_BLOCK_BYTES, length - from);
+        memcpy((unsigned char *)destination + from,
+               (const unsigned char *)source + from, block);
+        checksum.update((const unsigned char *)destination + from, block);
+    }
+    return checksum.digest();
+}
+
+/* Hand a GmicImage's buffer over to a gmic_list at a given position. Run this
+ * typically before a gmic.run(). The buffer is moved without any copy and
+ * the GmicImage is left empty until swap_gmic_list_item_into_gmic_image()
+ * gives it a buffer back. If the GmicImage may still be read from Python
+ * meanwhile (ie. can_move is false), its contents are copied instead, and
+ * their checksum is stored into 'checksum' if not NULL. */
+static void
+swap_gmic_image_into_gmic_list(PyGmicImage *image, gmic_list<T> &images,
+                               int position, bool can_move,
+                               uint64_t *checksum = NULL)
+{
+    if (can_move) {
+        images[position].swap(*image->_gmic_image);
+        return;
+    }
+
+    images[position].assign(
+        image->_gmic_image->_width, image->_gmic_image->_height,
+        image->_gmic_image->_depth, image->_gmic_image->_spectrum);
+    if (checksum != NULL) {
+        *checksum = gmicpy_copy_pixels_with_checksum(
+            images[position]._data, image->_gmic_image->_data,
+            image->_gmic_image->size());
+    }
+    else {
+        memcpy(images[position]._data, image->_gmic_image->_data,
+               image->_gmic_image->size() * sizeof(T));
+    }
+    // Pixels shared with an owner object are copied into a buffer G'MIC
+    // owns, so that commands can reallocate it
+    images[position]._is_shared =
+        image->_owner_buffer.obj == NULL && image->_gmic_image->_is_shared;
+}
+
+/* Stop sharing a GmicImage's pixels with their owner object (see
+ * GmicImage.from_numpy_helper(copy=False)), once its gmic_image got a buffer
+ * of its own. */
+static void
+gmicpy_gmic_image_release_owner(PyGmicImage *image)
+{
+    if (image->_owner_buffer.obj != NULL) {
+        PyBuffer_Release(&image->_owner_buffer);
+        image->_owner_buffer.obj = NULL;
+    }
+}
+
+/* Move a GmicList's image at given index into an external GmicImage, without
+ * copying its buffer. Run this typically after gmic.run(). */
+static void
+swap_gmic_list_item_into_gmic_image(gmic_list<T> &images, int position,
+                                    PyGmicImage *image)
+{
+    // Put back the possibly modified reallocated image buffer into the
+    // original external GmicImage, then free the external image's former
+    // buffer (if any) now lying in the gmic_list
+    images[position].swap(*image->_gmic_image);
+    images[position].assign();
+}
+
+static bool
+gmicpy_gmic_image_has_same_dimensions(const gmic_image<T> &image,
+                                      const gmic_image<T> &other)
+{
+    return image._width == other._width && image._height == other._height &&
+           image._depth == other._depth && image._spectrum == other._spectrum;
+}
+
+/* Build a new GmicImage taking over a gmic_list item's buffer, without
+ * copying it. Run this typically after gmic.run(). */
+static PyObject *
+new_gmic_image_from_gmic_list_item(gmic_list<T> &images, int position)
+{
+    PyGmicImage *image =
+        (PyGmicImage *)PyGmicImageType.tp_alloc(&PyGmicImageType, 0);
+
+    if (image == NULL) {
+        return NULL;
+    }
+    swap_gmic_list_item_into_gmic_image(images, position, image);
+
+    return (PyObject *)image;
+}
+
+/* Bring a gmic_list item back into an existing GmicImage after gmic.run().
+ * Buffers exported or shared with an owner object (eg. a numpy array) stay
+ * in place and get same-sized results copied into them, while other
+ * GmicImages take over the result buffer. Returns false, leaving the
+ * GmicImage untouched, if its exported buffer cannot fit the result. */
+static bool
+gmicpy_store_gmic_list_item_into_gmic_image(gmic_list<T> &images,
+                                            int position, PyGmicImage *image)
+{
+    if ((image->_exports > 0 || image->_owner_buffer.obj != NULL) &&
+        gmicpy_gmic_image_has_same_dimensions(images[position],
+                                              *image->_gmic_image)) {
+        memcpy(image->_gmic_image->_data, images[position]._data,
+               images[position].size() * sizeof(T));
+        images[position].assign();
+        return true;
+    }
+    if (image->_exports > 0) {
+        return false;
+    }
+    swap_gmic_list_item_into_gmic_image(images, position, image);
+    gmicpy_gmic_image_release_owner(image);
+
+    return true;
+}
+
+//------- PIXELS LAYOUT CONVERSION KERNELS ----------//
+
+/* G'MIC images are planar (ie. RRR,GGG,BBB) while numpy, PIL or raw frames
+ * are usually packed (ie. RGB,RGB,RGB). These kernels convert between both
+ * layouts sequentially over ranges of pixels, with fixed channel counts
+ * unrolled so that compilers vectorize them, and with SSE or NEON code for
+ * float32 RGB and RGBA pixels. They cast pixel values on the fly too, and
+ * large images get split across OpenMP threads. */
+
+/* Cast a pixel value. Floating values going into integer types are rounded
+ * and clamped to the type's range (NaN becoming its minimum), rather than
+ * truncated and wrapped around. */
+template <typename tc>
+struct gmicpy_pixel_cast {
+    template <typename tp>
+    static inline tc cast(tp value)
+    {
+        if (!std::numeric_limits<tc>::is_integer ||
+            std::numeric_limits<tp>::is_integer) {
+            return (tc)value;
+        }
+        if (!(value > (tp)std::numeric_limits<tc>::min())) {
+            return std::numeric_limits<tc>::min();
+        }
+        if (value >= (tp)std::numeric_limits<tc>::max()) {
+            return std::numeric_limits<tc>::max();
+        }
+        return (tc)std::floor(value + (tp)0.5);
+    }
+};
+
+// Booleans are true for any non-zero value, as with numpy casts
+template <>
+struct gmicpy_pixel_cast<bool> {
+    template <typename tp>
+    static inline bool cast(tp value)
+    {
+        return value != 0;
+    }
+};
+
+template <unsigned int spectrum, typename tp, typename tc>
+static void
+gmicpy_deinterleave_n(const tp *packed, tc *planar, size_t pixels,
+                      size_t from, size_t to)
+{
+    for (size_t p = from; p < to; p++) {
+        for (unsigned int c = 0; c < spectrum; c++) {
+            planar[c * pixels + p] =
+                gmicpy_pixel_cast<tc>::cast(packed[p * spectrum + c]);
+        }
+    }
+}
+
+template <unsigned int spectrum, typename tp, typename tc>
+static void
+gmicpy_interleave_n(const tp *planar, tc *packed, size_t pixels, size_t from,
+                    size_t to)
+{
+    for (size_t p = from; p < to; p++) {
+        for (unsigned int c = 0; c < spectrum; c++) {
+            packed[p * spectrum + c] =
+                gmicpy_pixel_cast<tc>::cast(planar[c * pixels + p]);
+        }
+    }
+}
+
+/* Convert the [from, to) range of an image's packed pixels into planar
+ * ones. */
+template <typename tp, typename tc>
+static void
+gmicpy_deinterleave_range(const tp *packed, tc *planar, size_t pixels,
+                          unsigned int spectrum, size_t from, size_t to)
+{
+    switch (spectrum) {
+        case 1:
+            gmicpy_deinterleave_n<1>(packed, planar, pixels, from, to);
+            break;
+        case 2:
+            gmicpy_deinterleave_n<2>(packed, planar, pixels, from, to);
+            break;
+        case 3:
+            gmicpy_deinterleave_n<3>(packed, planar, pixels, from, to);
+            break;
+        case 4:
+            gmicpy_deinterleave_n<4>(packed, planar, pixels, from, to);
+            break;
+        default:
+            // Write one channel plane at a time
+            for (unsigned int c = 0; c < spectrum; c++) {
+                for (size_t p = from; p < to; p++) {
+                    planar[c * pixels + p] =
+                        gmicpy_pixel_cast<tc>::cast(packed[p * spectrum + c]);
+                }
+            }
+    }
+}
+
+/* Convert the [from, to) range of an image's planar pixels into packed
+ * ones. */
+template <typename tp, typename tc>
+static void
+gmicpy_interleave_range(const tp *planar, tc *packed, size_t pixels,
+                        unsigned int spectrum, size_t from, size_t to)
+{
+    switch (spectrum) {
+        case 1:
+            gmicpy_interleave_n<1>(planar, packed, pixels, from, to);
+            break;
+        case 2:
+            gmicpy_interleave_n<2>(planar, packed, pixels, from, to);
+            break;
+        case 3:
+            gmicpy_interleave_n<3>(planar, packed, pixels, from, to);
+            break;
+        case 4:
+            gmicpy_interleave_n<4>(planar, packed, pixels, from, to);
+            break;
+        default:
+            // Read one channel plane at a time
+            for (unsigned int c = 0; c < spectrum; c++) {
+                for (size_t p = from; p < to; p++) {
+                    packed[p * spectrum + c] =
+                        gmicpy_pixel_cast<tc>::cast(planar[c * pixels + p]);
+                }
+            }
+    }
+}
+
+#if defined(GMICPY_SIMD_SSE) || defined(GMICPY_SIMD_NEON)
+/* Overloads for float32 pixels, with the scalar kernels above taking care
+ * of remaining pixels and other channel counts. */
+static void
+gmicpy_deinterleave_range(const float *packed, float *planar, size_t pixels,
+                          unsigned int spectrum, size_t from, size_t to)
+{
+    size_t p = from;
+    float *r = planar, *g = planar + pixels, *b = planar + 2 * pixels,
+          *a = planar + 3 * pixels;
+
+#if defined(GMICPY_SIMD_SSE)
+    if (spectrum == 3) {
+        for (; p + 4 <= to; p += 4) {
+            const float *source = packed + p * 3;
+            __m128 p0 = _mm_loadu_ps(source), p1 = _mm_loadu_ps(source + 4),
+                   p2 = _mm_loadu_ps(source + 8);
+            // p0 = r0 g0 b0 r1, p1 = g1 b1 r2 g2, p2 = b2 r3 g3 b3
+            __m128 r23 = _mm_shuffle_ps(p1, p2, _MM_SHUFFLE(1, 1, 2, 2));
+            __m128 g01 = _mm_shuffle_ps(p0, p1, _MM_SHUFFLE(0, 0, 1, 1));
+            __m128 g23 = _mm_shuffle_ps(p1, p2, _MM_SHUFFLE(2, 2, 3, 3));
+            __m128 b01 = _mm_shuffle_ps(p0, p1, _MM_SHUFFLE(1, 1, 2, 2));
+            __m128 b23 = _mm_shuffle_ps(p2, p2, _MM_SHUFFLE(3, 3, 0, 0));
+            _mm_storeu_ps(r + p,
+                          _mm_shuffle_ps(p0, r23, _MM_SHUFFLE(2, 0, 3, 0)));
+            _mm_storeu_ps(g + p,
+                          _mm_shuffle_ps(g01, g23, _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(b + p,
+                          _mm_shuffle_ps(b01, b23, _MM_SHUFFLE(2, 0, 2, 0)));
+        }
+    }
+    else if (spectrum == 4) {
+        for (; p + 4 <= to; p += 4) {
+            const float *source = packed + p * 4;
+            __m128 p0 = _mm_loadu_ps(source), p1 = _mm_loadu_ps(source + 4),
+                   p2 = _mm_loadu_ps(source + 8),
+                   p3 = _mm_loadu_ps(source + 12);
+            _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+            _mm_storeu_ps(r + p, p0);
+            _mm_storeu_ps(g + p, p1);
+            _mm_storeu_ps(b + p, p2);
+            _mm_storeu_ps(a + p, p3);
+        }
+    }
+#elif defined(GMICPY_SIMD_NEON)
+    if (spectrum == 3) {
+        for (; p + 4 <= to; p += 4) {
+            float32x4x3_t rgb = vld3q_f32(packed + p * 3);
+            vst1q_f32(r + p, rgb.val[0]);
+            vst1q_f32(g + p, rgb.val[1]);
+            vst1q_f32(b + p, rgb.val[2]);
+        }
+    }
+    else if (spectrum == 4) {
+        for (; p + 4 <= to; p += 4) {
+            float32x4x4_t rgba = vld4q_f32(packed + p * 4);
+            vst1q_f32(r + p, rgba.val[0]);
+            vst1q_f32(g + p, rgba.val[1]);
+            vst1q_f32(b + p, rgba.val[2]);
+            vst1q_f32(a + p, rgba.val[3]);
+        }
+    }
+#endif
+    gmicpy_deinterleave_range<float, float>(packed, planar, pixels, spectrum,
+                                            p, to);
+}
+
+static void
+gmicpy_interleave_range(const float *planar, float *packed, size_t pixels,
+                        unsigned int spectrum, size_t from, size_t to)
+{
+    size_t p = from;
+    const float *r = planar, *g = planar + pixels, *b = planar + 2 * pixels,
+                *a = planar + 3 * pixels;
+
+#if defined(GMICPY_SIMD_SSE)
+    if (spectrum == 3) {
+        for (; p + 4 <= to; p += 4) {
+            float *destination = packed + p * 3;
+            __m128 vr = _mm_loadu_ps(r + p), vg = _mm_loadu_ps(g + p),
+                   vb = _mm_loadu_ps(b + p);
+            __m128 rg01 = _mm_unpacklo_ps(vr, vg);  // r0 g0 r1 g1
+            __m128 rg23 = _mm_unpackhi_ps(vr, vg);  // r2 g2 r3 g3
+            __m128 b0r1 = _mm_shuffle_ps(vb, vr, _MM_SHUFFLE(1, 1, 0, 0));
+            __m128 g1b1 = _mm_shuffle_ps(vg, vb, _MM_SHUFFLE(1, 1, 1, 1));
+            __m128 b2r3 = _mm_shuffle_ps(vb, vr, _MM_SHUFFLE(3, 3, 2, 2));
+            __m128 g3b3 = _mm_shuffle_ps(vg, vb, _MM_SHUFFLE(3, 3, 3, 3));
+            _mm_storeu_ps(destination,
+                          _mm_shuffle_ps(rg01, b0r1, _MM_SHUFFLE(2, 0, 1, 0)));
+            _mm_storeu_ps(destination + 4,
+                          _mm_shuffle_ps(g1b1, rg23, _MM_SHUFFLE(1, 0, 2, 0)));
+            _mm_storeu_ps(destination + 8,
+                          _mm_shuffle_ps(b2r3, g3b3, _MM_SHUFFLE(2, 0, 2, 0)));
+        }
+    }
+    else if (spectrum == 4) {
+        for (; p + 4 <= to; p += 4) {
+            float *destination = packed + p * 4;
+            __m128 p0 = _mm_loadu_ps(r + p), p1 = _mm_loadu_ps(g + p),
+                   p2 = _mm_loadu_ps(b + p), p3 = _mm_loadu_ps(a + p);
+            _MM_TRANSPOSE4_PS(p0, p1, p2, p3);
+            _mm_storeu_ps(destination, p0);
+            _mm_storeu_ps(destination + 4, p1);
+            _mm_storeu_ps(destination + 8, p2);
+            _mm_storeu_ps(destination + 12, p3);
+        }
+    }
+#elif defined(GMICPY_SIMD_NEON)
+    if (spectrum == 3) {
+        for (; p + 4 <= to; p += 4) {
+            float32x4x3_t rgb;
+            rgb.val[0] = vld1q_f32(r + p);
+            rgb.val[1] = vld1q_f32(g + p);
+            rgb.val[2] = vld1q_f32(b + p);
+            vst3q_f32(packed + p * 3, rgb);
+        }
+    }
+    else if (spectrum == 4) {
+        for (; p + 4 <= to; p += 4) {
+            float32x4x4_t rgba;
+            rgba.val[0] = vld1q_f32(r + p);
+            rgba.val[1] = vld1q_f32(g + p);
+            rgba.val[2] = vld1q_f32(b + p);
+            rgba.val[3] = vld1q_f32(a + p);
+            vst4q_f32(packed + p * 4, rgba);
+        }
+    }
+#endif
+    gmicpy_interleave_range<float, float>(planar, packed, pixels, spectrum, p,
+                                          to);
+}
+#endif
+
+// Minimum number of pixel values for a conversion to be split across
+// threads, below which threading costs more than it saves
+#define GMICPY_CONVERSION_PARALLEL_THRESHOLD (1 << 20)
+
+/* Number of threads OpenMP-enabled G'MIC commands may use. */
+static int
+gmicpy_openmp_threads()
+{
+#if cimg_use_openmp != 0
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+/* Number of threads converting a given number of pixel values. Large
+ * conversions use the GMIC_PY_CONVERSION_THREADS environment variable's
+ * count if set, or as many threads as G'MIC commands. */
+static int
+gmicpy_conversion_threads(size_t values)
+{
+    const char *threads_string = getenv("GMIC_PY_CONVERSION_THREADS");
+    int threads = threads_string != NULL ? atoi(threads_string) : 0;
+
+    if (values < GMICPY_CONVERSION_PARALLEL_THRESHOLD) {
+        return 1;
+    }
+
+    return threads > 0 ? threads : gmicpy_openmp_threads();
+}
+
+/* Convert packed pixels into planar ones, split into one range of pixels
+ * per thread. */
+template <typename tp, typename tc>
+static void
+gmicpy_deinterleave(const tp *packed, tc *planar, size_t pixels,
+                    unsigned int spectrum)
+{
+    const int threads = gmicpy_conversion_threads(pixels * spectrum);
+    const size_t range = (pixels + threads - 1) / threads;
+
+#if cimg_use_openmp != 0
+#pragma omp parallel for num_threads(threads) if (threads > 1)
+#endif
+    for (int thread = 0; thread < threads; thread++) {
+        size_t from = std::min(pixels, thread * range);
+        gmicpy_deinterleave_range(packed, planar, pixels, spectrum, from,
+                                  std::min(pixels, from + range));
+    }
+}
+
+/* Convert planar pixels into packed ones, split into one range of pixels
+ * per thread. */
+template <typename tp, typename tc>
+static void
+gmicpy_interleave(const tp *planar, tc *packed, size_t pixels,
+                  unsigned int spectrum)
+{
+    const int threads = gmicpy_conversion_threads(pixels * spectrum);
+    const size_t range = (pixels + threads - 1) / threads;
+
+#if cimg_use_openmp != 0
+#pragma omp parallel for num_threads(threads) if (threads > 1)
+#endif
+    for (int thread = 0; thread < threads; thread++) {
+        size_t from = std::min(pixels, thread * range);
+        gmicpy_interleave_range(planar, packed, pixels, spectrum, from,
+                                std::min(pixels, from + range));
+    }
+}
+
+// Side of the square tiles of gmicpy_interleave_x_major()
+#define GMICPY_CONVERSION_TILE 32
+
+/* Interleave an image into a C-ordered (width, height, depth, spectrum)
+ * matrix, ie. with x as the outermost axis. This transposes pixels too, so
+ * each slice is walked through square tiles of (x, y) coordinates that fit
+ * in cache, instead of striding across the whole image for each pixel.
+ * Threads share columns of tiles. */
+template <typename tc>
+static void
+gmicpy_interleave_x_major(const gmic_image<T> &image, tc *packed)
+{
+    const size_t width = image._width, height = image._height,
+                 depth = image._depth;
+    const size_t plane = width * height * depth;
+    const unsigned int spectrum = image._spectrum;
+    const size_t columns =
+        (width + GMICPY_CONVERSION_TILE - 1) / GMICPY_CONVERSION_TILE;
+    const long slice_columns = (long)(depth * columns);
+    const int threads = gmicpy_conversion_threads(image.size());
+
+#if cimg_use_openmp != 0
+#pragma omp parallel for num_threads(threads) if (threads > 1)
+#endif
+    for (long slice_column = 0; slice_column < slice_columns;
+         slice_column++) {
+        size_t z = slice_column / columns;
+        size_t x0 = (slice_column % columns) * GMICPY_CONVERSION_TILE;
+        size_t x1 = std::min(x0 + GMICPY_CONVERSION_TILE, width);
+        for (size_t y0 = 0; y0 < height; y0 += GMICPY_CONVERSION_TILE) {
+            size_t y1 = std::min(y0 + GMICPY_CONVERSION_TILE, height);
+            for (size_t x = x0; x < x1; x++) {
+                for (size_t y = y0; y < y1; y++) {
+                    const T *source =
+                        image._data + x + width * (y + height * z);
+                    tc *destination =
+                        packed + ((x * height + y) * depth + z) * spectrum;
+                    for (unsigned int c = 0; c < spectrum; c++) {
+                        destination[c] =
+                            gmicpy_pixel_cast<tc>::cast(source[c * plane]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+/* Fill an image from the C-ordered items of a matrix, which are either
+ * packed pixels (deinterleave is true) or already in G'MIC's planar order.
+ * Packed items of a single slice come in (height, width, spectrum) order,
+ * and those of several slices in (depth, height, width, spectrum) order,
+ * ie. pixels in G'MIC's (z, y, x) order either way. */
+template <typename tp>
+static void
+gmicpy_import_pixels(const tp *source, gmic_image<T> &image, bool deinterleave)
+{
+    if (!deinterleave) {
+        // A single channel needs no deinterleaving, only casting
+        gmicpy_deinterleave(source, image._data, image.size(), 1);
+    }
+    else {
+        gmicpy_deinterleave(source, image._data,
+                            (size_t)image._width * image._height *
+                                image._depth,
+                            image._spectrum);
+    }
+}
+
+/* Fill an image from the items of a (width, height, depth, spectrum)
+ * tensor with arbitrary strides, counted in items. Compact planar and
+ * packed tensors go through the kernels above, while other layouts are
+ * gathered one row of G'MIC pixels at a time. */
+template <typename tp>
+static void
+gmicpy_import_strided_pixels(const tp *source, const int64_t *strides,
+                             gmic_image<T> &image)
+{
+    const int64_t width = image._width, height = image._height,
+                  depth = image._depth, spectrum = image._spectrum;
+    const int64_t planar_strides[4] = {1, width, width * height,
+                                       width * height * depth};
+    const int64_t packed_strides[4] = {spectrum, width * spectrum,
+                                       width * height * spectrum, 1};
+    const int64_t shape[4] = {width, height, depth, spectrum};
+    bool is_planar = true, is_packed = true;
+
+    // Strides of single-item axes never get used
+    for (int axis = 0; axis < 4; axis++) {
+        is_planar &= shape[axis] == 1 || strides[axis] == planar_strides[axis];
+        is_packed &= shape[axis] == 1 || strides[axis] == packed_strides[axis];
+    }
+    if (is_planar || is_packed) {
+        gmicpy_import_pixels(source, image, !is_planar);
+        return;
+    }
+
+    const long rows = (long)(height * depth * spectrum);
+    const int threads = gmicpy_conversion_threads(image.size());
+
+#if cimg_use_openmp != 0
+#pragma omp parallel for num_threads(threads) if (threads > 1)
+#endif
+    for (long row = 0; row < rows; row++) {
+        const int64_t y = row % height, z = (row / height) % depth,
+                      c = row / (height * depth);
+        const tp *line =
+            source + y * strides[1] + z * strides[2] + c * strides[3];
+        T *destination = image._data + row * width;
+        for (int64_t x = 0; x < width; x++) {
+            destination[x] = gmicpy_pixel_cast<T>::cast(line[x * strides[0]]);
+        }
+    }
+}
+
+enum gmicpy_pixels_layout {
+    // G'MIC's own (spectrum, depth, height, width) C order
+    GMICPY_PIXELS_PLANAR,
+    // (depth, height, width, spectrum) C order
+    GMICPY_PIXELS_INTERLEAVED,
+    // (width, height, depth, spectrum) C order
+    GMICPY_PIXELS_INTERLEAVED_X_MAJOR
+};
+
+/* Write an image's pixels into a matrix buffer of a given layout. */
+template <typename tc>
+static void
+gmicpy_export_pixels(const gmic_image<T> &image, tc *destination,
+                     gmicpy_pixels_layout layout)
+{
+    switch (layout) {
+        case GMICPY_PIXELS_PLANAR:
+            gmicpy_interleave(image._data, destination, image.size(), 1);
+            break;
+        case GMICPY_PIXELS_INTERLEAVED:
+            gmicpy_interleave(image._data, destination,
+                              (size_t)image._width * image._height *
+                                  image._depth,
+                              image._spectrum);
+            break;
+        case GMICPY_PIXELS_INTERLEAVED_X_MAJOR:
+            gmicpy_interleave_x_major(image, destination);
+            break;
+    }
+}
+
+/* Fill an image from a matrix buffer whose items have a Python buffer
+ * format among "?bBhHiIlLqQfd" (see gmicpy_import_pixels()). */
+static void
+gmicpy_import_pixels_from(const void *source, char format,
+                          gmic_image<T> &image, bool deinterleave)
+{
+    switch (format) {
+        case '?':
+            gmicpy_import_pixels((const bool *)source, image, deinterleave);
+            break;
+        case 'b':
+            gmicpy_import_pixels((const signed char *)source, image,
+                                 deinterleave);
+            break;
+        case 'B':
+            gmicpy_import_pixels((const unsigned char *)source, image,
+                                 deinterleave);
+            break;
+        case 'h':
+            gmicpy_import_pixels((const short *)source, image, deinterleave);
+            break;
+        case 'H':
+            gmicpy_import_pixels((const unsigned short *)source, image,
+                                 deinterleave);
+            break;
+        case 'i':
+            gmicpy_import_pixels((const int *)source, image, deinterleave);
+            break;
+        case 'I':
+            gmicpy_import_pixels((const unsigned int *)source, image,
+                                 deinterleave);
+            break;
+        case 'l':
+            gmicpy_import_pixels((const long *)source, image, deinterleave);
+            break;
+        case 'L':
+            gmicpy_import_pixels((const unsigned long *)source, image,
+                                 deinterleave);
+            break;
+        case 'q':
+            gmicpy_import_pixels((const long long *)source, image,
+                                 deinterleave);
+            break;
+        case 'Q':
+            gmicpy_import_pixels((const unsigned long long *)source, image,
+                                 deinterleave);
+            break;
+        case 'd':
+            gmicpy_import_pixels((const double *)source, image, deinterleave);
+            break;
+        default:  // 'f'
+            gmicpy_import_pixels((const float *)source, image, deinterleave);
+    }
+}
+
+/* Write an image's pixels into a matrix buffer whose items have a Python
+ * buffer format among "?bBhHiIfd". */
+static void
+gmicpy_export_pixels_to(const gmic_image<T> &image, void *destination,
+                        char format, gmicpy_pixels_layout layout)
+{
+    switch (format) {
+        case '?':
+            gmicpy_export_pixels(image, (bool *)destination, layout);
+            break;
+        case 'b':
+            gmicpy_export_pixels(image, (signed char *)destination, layout);
+            break;
+        case 'B':
+            gmicpy_export_pixels(image, (unsigned char *)destination, layout);
+            break;
+        case 'h':
+            gmicpy_export_pixels(image, (short *)destination, layout);
+            break;
+        case 'H':
+            gmicpy_export_pixels(image, (unsigned short *)destination,
+                                 layout);
+            break;
+        case 'i':
+            gmicpy_export_pixels(image, (int *)destination, layout);
+            break;
+        case 'I':
+            gmicpy_export_pixels(image, (unsigned int *)destination, layout);
+            break;
+        case 'd':
+            gmicpy_export_pixels(image, (double *)destination, layout);
+            break;
+        default:  // 'f'
+            gmicpy_export_pixels(image, (float *)destination, layout);
+    }
+}
+
+/* Fill an image from a strided tensor whose items have a Python buffer
+ * format among "?bBhHiIfd" (see gmicpy_import_strided_pixels()). */
+static void
+gmicpy_import_strided_pixels_from(const void *source, char format,
+                                  const int64_t *strides,
+                                  gmic_image<T> &image)
+{
+    switch (format) {
+        case '?':
+            gmicpy_import_strided_pixels((const bool *)source, strides,
+                                         image);
+            break;
+        case 'b':
+            gmicpy_import_strided_pixels((const signed char *)source, strides,
+                                         image);
+            break;
+        case 'B':
+            gmicpy_import_strided_pixels((const unsigned char *)source,
+                                         strides, image);
+            break;
+        case 'h':
+            gmicpy_import_strided_pixels((const short *)source, strides,
+                                         image);
+            break;
+        case 'H':
+            gmicpy_import_strided_pixels((const unsigned short *)source,
+                                         strides, image);
+            break;
+        case 'i':
+            gmicpy_import_strided_pixels((const int *)source, strides, image);
+            break;
+        case 'I':
+            gmicpy_import_strided_pixels((const unsigned int *)source,
+                                         strides, image);
+            break;
+        case 'd':
+            gmicpy_import_strided_pixels((const double *)source, strides,
+                                         image);
+            break;
+        default:  // 'f'
+            gmicpy_import_strided_pixels((const float *)source, strides,
+                                         image);
+    }
+}
+
+#ifdef gmic_py_jupyter_ipython_display
+
+// Cross-platform way to have a temp directory string, through Python
+const char *
+get_temp_dir()
+{
+    PyObject *module = NULL;
+    PyObject *pystr = NULL;
+    module = PyImport_ImportModule("tempfile");
+    pystr = PyObject_CallMethod(module, "gettempdir", NULL);
+    Py_XDECREF(pystr);
+    Py_XDECREF(module);
+    return PyUnicode_AsUTF8(pystr);
+}
+
+// Cross-platform way to have a unique id string, through Python
+const char *
+get_uuid()
+{
+    PyObject *module = NULL;
+    PyObject *pystr = NULL;
+    module = PyImport_ImportModule("uuid");
+    // Using a time-sortable uuid generator for file names
+    // See https://stackoverflow.com/a/63970430/420684
+    pystr = PyObject_Str(PyObject_CallMethod(module, "uuid1", "II", 0, 0));
+    Py_XDECREF(pystr);
+    Py_XDECREF(module);
+    return PyUnicode_AsUTF8(pystr);
+}
+
+// You must free the result if result is non-NULL.
+// Modified from https://stackoverflow.com/a/779960/420684
+// Returns: a tuple of (adapted_gmic_command_string, ["a list of
+// fi*le*","glob*","strings*"])
+PyObject *
+gmic_py_str_replace_display_to_output(char *orig, char *extension)
+{
+    PyObject *pyresult = NULL;  // A (result_commands_line, (list,of,filename,
+                                // glob,strings)) 2-elements tuple
+    PyObject *pyglobs = NULL;   // A (result_commands_line, (list,of,filename,
+                                // glob,strings)) 2-elements tuple
+    char rep[] = " display";    // The string to seek and replace, ie. needle
+    char replacement_command[] =
+        " display output ";  // The string to seek and replace, ie. needle
+    char *result;            // the return string
+    char *ins;               // the next insert point
+    char *tmp;               // varies
+    int len_rep;             // length of rep (the string to remove)
+    int len_with;            // length of with (the string to replace rep with)
+    int len_front;           // distance between rep and end of last rep
+    int count;               // number of replacements
+    char with[512];          // replacement path
+    char with_globbed[512];  // replacement path with glob ending
+
+    with[0] = '\0';
+    with_globbed[0] = '\0';
+    pyglobs = PyList_New(0);
+    Py_INCREF(pyglobs);
+
+    // sanity checks and initialization
+    if (!orig || !rep)
+        return NULL;
+    len_rep = strlen(rep);
+    if (len_rep == 0)
+        return NULL;  // empty rep causes infinite loop during count
+
+    // build a first uuid to detect fixed replacement string length
+    // 'with' becomes thus '/tmp/unique-id.png'
+    // 'with_globbed' becomes '/tmp/unique-id*.png'
+    strcat(with, replacement_command);
+    strcat(with, get_temp_dir());
+    strcat(with, "/");
+    strcat(with, get_uuid());
+    strcpy(with_globbed, with);
+    strcat(with_globbed, "*");
+    strcat(with, extension);
+    strcat(with_globbed, extension);
+    len_with = strlen(with);
+
+    // count the number of replacements needed
+    ins = orig;
+    for (count = 0; (tmp = strstr(ins, rep)); ++count) {
+        ins = tmp + len_rep;
+    }
+
+    tmp = result =
+        (char *)malloc(strlen(orig) + (len_with - len_rep) * count + 1);
+
+    if (!result)
+        return NULL;
+
+    // first time through the loop, all the variable are set correctly
+    // from here on,
+    //    tmp points to the end of the result string
+    //    ins points to the next occurrence of rep in orig
+    //    orig points to the remainder of orig after "end of rep"
+    while (count--) {
+        PyList_Append(
+            pyglobs,
+            Py_BuildValue("s", with_globbed + strlen(replacement_command)));
+        ins = strstr(orig, rep);
+
+        len_front = ins - orig;
+        tmp = strncpy(tmp, orig, len_front) + len_front;
+        tmp = strcpy(tmp, with) + len_with;
+        orig += len_front + len_rep;  // move to next "end of rep"
+
+        // recompute a uuid file path for each replacement
+        with[0] = '\0';
+        with_globbed[0] = '\0';
+        strcat(with, replacement_command);
+        strcat(with, get_temp_dir());
+        strcat(with, "/");
+        strcat(with, get_uuid());
+        strcpy(with_globbed, with);
+        strcat(with_globbed, "*");
+        strcat(with, extension);
+        strcat(with_globbed, extension);
+    }
+    strcpy(tmp, orig);
+
+    pyresult = PyList_New(0);
+    PyList_Append(pyresult, Py_BuildValue("s", result));
+    PyList_Append(pyresult, pyglobs);
+    Py_DECREF(pyglobs);
+
+    return pyresult;
+}
+
+PyObject *
+gmic_py_display_with_matplotlib_or_ipython(PyObject *image_files_glob_strings)
+{
+    if (!PyList_Check(image_files_glob_strings)) {
+        PyErr_Format(GmicException, "input globs list is not a Python list");
+
+        return NULL;
+    }
+    PyObject *ipython_display_module = NULL;
+    PyObject *matplotlib_pyplot_module = NULL;
+    PyObject *matplotlib_image_module = NULL;
+    PyObject *glob_module = NULL;
+    PyObject *image_glob_str = NULL;
+    PyObject *image_expanded_filenames = NULL;
+    PyObject *all_image_expanded_filenames = NULL;
+    PyObject *image = NULL;
+    PyObject *display_result = NULL;
+    unsigned int nb_subplots = 0;
+    int matplotlib_subplot_id = 1;
+    bool use_matplotlib = false;
+    bool use_ipython = false;
+    unsigned int i = 0;
+    unsigned int j = 0;
+    matplotlib_pyplot_module = PyImport_ImportModule("matplotlib.pyplot");
+    if (matplotlib_pyplot_module == NULL) {
+        use_matplotlib = false;
+        ipython_display_module = PyImport_ImportModule("IPython.core.display");
+        if (ipython_display_module == NULL) {
+            use_ipython = false;
+            PyErr_Clear();
+            PyErr_Format(GmicException,
+                         "Could not use matplotlib neither ipython to try to "
+                         "display images");
+            return NULL;
+        }
+        else {
+            PyErr_Clear();
+            use_ipython = true;
+        }
+    }
+    else {
+        use_matplotlib = true;
+        use_ipython = false;
+        matplotlib_image_module = PyImport_ImportModule("matplotlib.image");
+    }
+
+    all_image_expanded_filenames = PyList_New(0);
+    glob_module = PyImport_ImportModule("glob");
+    for (i = 0; i < PyList_Size(image_files_glob_strings); i++) {
+        // display(Image('image_path...', unconfined=True))
+        image_glob_str = PyList_GetItem(image_files_glob_strings, i);
+        image_expanded_filenames =
+            PyObject_CallMethod(glob_module, "glob", "O", image_glob_str);
+        for (j = 0; j < PyList_Size(image_expanded_filenames); j++) {
+            PyList_Append(all_image_expanded_filenames,
+                          PyList_GetItem(image_expanded_filenames, j));
+        }
+    }
+    // Sort files by unique ID otherwise they will be in some kind of mess,
     // because glob.glob does not sort
     PyList_Sort(all_image_expanded_filenames);
 
-    nb_subplots = PyList_Size(all_image_expanded_filenames);
+    nb_subplots = PyList_Size(all_image_expanded_filenames);
+
+    for (j = 0; j < nb_subplots; j++) {
+        if (use_matplotlib) {
+            image = PyObject_CallMethod(
+                matplotlib_image_module, "imread", "O",
+                PyList_GetItem(all_image_expanded_filenames, j));
+            if (!image) {
+                return image;
+            }
+            display_result =
+                PyObject_CallMethod(matplotlib_pyplot_module, "subplot", "iii",
+                                    nb_subplots, 1, matplotlib_subplot_id++);
+            if (!display_result) {
+                return display_result;
+            }
+
+            display_result = PyObject_CallMethod(matplotlib_pyplot_module,
+                                                 "imshow", "O", image);
+            if (!display_result) {
+                return display_result;
+            }
+        }
+        else if (use_ipython) {
+            image = PyObject_CallMethod(
+                ipython_display_module, "Image", "O",
+                PyList_GetItem(all_image_expanded_filenames, j));
+            if (image == NULL) {
+                return image;
+            }
+            display_result = PyObject_CallMethod(ipython_display_module,
+                                                 "display", "O", image);
+            if (display_result == NULL) {
+                return display_result;
+            }
+        }
+        else {
+            PyErr_Format(GmicException,
+                         "Logic error: matplotlib or ipython should have "
+                         "been imported at this point.");
+            return NULL;
+        }
+    }
+    // Matplolib requires only one single image display call, for multiple
+    // images
+    if (use_matplotlib) {
+        display_result =
+            PyObject_CallMethod(matplotlib_pyplot_module, "show", NULL);
+        if (!display_result) {
+            return display_result;
+        }
+
+        Py_XDECREF(all_image_expanded_filenames);
+        Py_XDECREF(image_expanded_filenames);
+        Py_XDECREF(image_glob_str);
+        Py_XDECREF(image);
+    }
+
+    Py_XDECREF(ipython_display_module);
+    Py_XDECREF(matplotlib_pyplot_module);
+    Py_XDECREF(glob_module);
+
+    return display_result;
+}
+
+PyObject *
+autoload_wurlitzer_into_ipython()
+{
+    PyObject *wurlitzer_module = NULL;
+    PyObject *ipython_module = NULL;
+    PyObject *ipython_handler = NULL;
+    PyObject *ipython_run_line_magic_result = NULL;
+    PyObject *ipython_loaded_extensions = NULL;
+
+    if (cimg_OS == 1) {  // UNIX OSes
+        wurlitzer_module = PyImport_ImportModule("wurlitzer");
+        if (wurlitzer_module == NULL) {
+            PySys_WriteStdout(
+                "gmic-py: If you do not see any text for G'MIC "
+                "'print' or "
+                "'display' commands, you could '!pip install "
+                "wurlitzer' "
+                "and if under an IPython environment, run the "
+                "'%%load_ext "
+                "wurlitzer' macro. See "
+                "https://github.com/myselfhimself/gmic-py/issues/"
+                "64\n");
+            PyErr_Clear();
+        }
+        else {  // if wurlitzer module could be imported
+            ipython_module = PyImport_ImportModule("IPython");
+            if (ipython_module == NULL) {
+                PyErr_Clear();
+                Py_RETURN_NONE;
+            }
+            else {  // If IPython module found
+                ipython_handler =
+                    PyObject_CallMethod(ipython_module, "get_ipython", NULL);
+                if (ipython_handler == NULL) {
+                    PyErr_Clear();
+                    return NULL;
+                }
+                // Skip any wurlitzer imported if not in an IPython context, or
+                // if an IPython terminal
+                else if (ipython_handler == Py_None ||
+                         !PyObject_HasAttrString(ipython_handler, "kernel")) {
+                    // See
+                    // https://github.com/myselfhimself/gmic-py/issues/63#issuecomment-703533397
+                    Py_XDECREF(ipython_handler);
+                    Py_XDECREF(wurlitzer_module);
+                    Py_XDECREF(ipython_module);
+                    Py_RETURN_NONE;
+                }
+                else {
+                    ipython_loaded_extensions = PyObject_GetAttrString(
+                        PyObject_GetAttrString(ipython_handler,
+                                               "extension_manager"),
+                        "loaded");
+                    if (ipython_loaded_extensions == NULL) {
+                        PyErr_Clear();
+                    }
+                    else {
+                        // if wurlitzer extension not loaded yet into
+                        // IPython, try to load it
+                        if (PySet_Contains(
+                                ipython_loaded_extensions,
+                                PyUnicode_FromString("wurlitzer")) == 0) {
+                            ipython_run_line_magic_result =
+                                PyObject_CallMethod(ipython_handler,
+                                                    "run_line_magic", "ss",
+                                                    "load_ext", "wurlitzer");
+                            if (ipython_run_line_magic_result == NULL) {
+                                PySys_WriteStdout(
+                                    "gmic-py: managed to find IPython "
+                                    "but "
+                                    "could not call the '%%load_ext "
+                                    "wurltizer "
+                                    "macro for you. If you '!pip "
+                                    "install "
+                                    "wurlitzer' or install "
+                                    "'wurlitzer' in "
+                                    "your virtual environment, "
+                                    "gmic-py will "
+                                    "try to load it for you "
+                                    "automatically.\n");
+                                PyErr_Clear();
+                            }
+                            else {
+                                PySys_WriteStderr(
+                                    "gmic-py: wurlitzer found (for "
+                                    "G'MIC "
+                                    "stdout/stderr redirection) and "
+                                    "enabled "
+                                    "automatically through IPython "
+                                    "'%%load_ext wurlitzer'.\n");
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+    else {  // Non-UNIX OSes
+        PySys_WriteStdout(
+            "You are not on a UNIX-like OS and unless you do "
+            "have a "
+            "side-window console, you shall not see any text "
+            "for "
+            "G'MIC 'print' or 'display' commands output. Hope "
+            "you can "
+            "accept it so. See "
+            "https://github.com/myselfhimself/gmic-py/issues/"
+            "64\n");
+    }
+
+    Py_XDECREF(wurlitzer_module);
+    Py_XDECREF(ipython_module);
+    Py_XDECREF(ipython_handler);
+    Py_XDECREF(ipython_run_line_magic_result);
+    return ipython_run_line_magic_result;
+}
+
+// end gmic_py_jupyter_ipython_display
+#endif
+
+/* Python-side parameters of a G'MIC run and their gmic_list counterparts,
+ * from input marshalling before the run to results retrieval after it. */
+struct gmicpy_run_io {
+    PyObject *input_gmic_images;       // 'images' parameter, or NULL
+    PyObject *input_gmic_image_names;  // 'image_names' parameter, or NULL
+    // Snapshot of the 'images' list items, kept alive while G'MIC holds
+    // their buffers
+    PyObject *input_images_items;
+    gmic_list<T> images;
+    gmic_list<char> image_names;
+    // Number of input images handed over to G'MIC without a copy
+    Py_ssize_t moved_images_count;
+    // Whether each input image was handed over without a copy
+    std::vector<bool> moved_images;
+    // Buffer each exported or owner-backed input image was copied into for
+    // G'MIC, and the checksum of its pixels then, or NULL for other inputs
+    std::vector<const T *> loaded_buffers;
+    std::vector<uint64_t> loaded_checksums;
+    // Position in G'MIC's resulting list of each image kept by the 'outputs'
+    // run parameter, or empty if all are kept
+    std::vector<int> output_positions;
+    // Number of copied input images that G'MIC left untouched, and which
+    // were not copied back
+    Py_ssize_t untouched_images_count;
+
+    gmicpy_run_io()
+        : input_gmic_images(NULL),
+          input_gmic_image_names(NULL),
+          input_images_items(NULL),
+          moved_images_count(0),
+          untouched_images_count(0)
+    {
+    }
+};
+
+static void
+gmicpy_run_io_clear(gmicpy_run_io *io)
+{
+    Py_CLEAR(io->input_gmic_images);
+    Py_CLEAR(io->input_gmic_image_names);
+    Py_CLEAR(io->input_images_items);
+}
+
+/* Check 'images' and 'image_names' run parameters typing and fill the
+ * gmic_lists to run on. Input buffers are copied, unless move_inputs allows
+ * moving those of images that nobody else can observe. Returns false with
+ * a Python exception set on failure. Call gmicpy_run_io_clear() in any case
+ * when done. */
+static bool
+gmicpy_run_io_load(gmicpy_run_io *io, PyObject *input_gmic_images,
+                   PyObject *input_gmic_image_names, bool move_inputs)
+{
+    int image_position = 0;
+    int image_name_position = 0;
+    char *current_image_name_raw = NULL;
+    PyObject *current_image = NULL;
+    PyObject *current_image_name = NULL;
+
+    io->input_gmic_images =
+        input_gmic_images == Py_None ? NULL : input_gmic_images;
+    io->input_gmic_image_names =
+        input_gmic_image_names == Py_None ? NULL : input_gmic_image_names;
+    Py_XINCREF(io->input_gmic_images);
+    Py_XINCREF(io->input_gmic_image_names);
+    input_gmic_images = io->input_gmic_images;
+    input_gmic_image_names = io->input_gmic_image_names;
+
+    // Grab image names or single image name and check typings
+    if (input_gmic_image_names != NULL) {
+        // If list of image names provided
+        if (PyList_Check(input_gmic_image_names)) {
+            io->image_names.assign(PyList_GET_SIZE(input_gmic_image_names));
+
+            for (image_name_position = 0;
+                 image_name_position < (int)io->image_names.size();
+                 image_name_position++) {
+                current_image_name = PyList_GET_ITEM(input_gmic_image_names,
+                                                     image_name_position);
+                if (!PyUnicode_Check(current_image_name)) {
+                    PyErr_Format(PyExc_TypeError,
+                                 "'%.50s' input element found at position "
+                                 "%d in "
+                                 "'image_names' list is not a '%.400s'",
+                                 Py_TYPE(current_image_name)->tp_name,
+                                 image_name_position, PyUnicode_Type.tp_name);
+
+                    return false;
+                }
+
+                current_image_name_raw =
+                    (char *)PyUnicode_AsUTF8(current_image_name);
+                io->image_names[image_name_position].assign(
+                    strlen(current_image_name_raw) + 1);
+                memcpy(io->image_names[image_name_position]._data,
+                       current_image_name_raw,
+                       io->image_names[image_name_position]._width);
+            }
+
+            // If single image name provided
+        }
+        else if (PyUnicode_Check(input_gmic_image_names)) {
+            // Enforce also non-null single-GmicImage 'images'
+            // parameter
+            if (input_gmic_images != NULL &&
+                Py_TYPE(input_gmic_images) !=
+                    (PyTypeObject *)&PyGmicImageType) {
+                PyErr_Format(PyExc_TypeError,
+                             "'%.50s' 'images' parameter must be a "
+                             "'%.400s' if the "
+                             "'image_names' parameter is a bare '%.400s'.",
+                             Py_TYPE(input_gmic_images)->tp_name,
+                             PyGmicImageType.tp_name, PyUnicode_Type.tp_name);
+
+                return false;
+            }
+
+            io->image_names.assign(1);
+            current_image_name_raw =
+                (char *)PyUnicode_AsUTF8(input_gmic_image_names);
+            io->image_names[0].assign(strlen(current_image_name_raw) + 1);
+            memcpy(io->image_names[0]._data, current_image_name_raw,
+                   io->image_names[0]._width);
+            // If neither a list of strings nor a single string
+            // were provided, raise exception
+        }
+        else {
+            PyErr_Format(PyExc_TypeError,
+                         "'%.50s' 'image_names' parameter must be a list "
+                         "of '%.400s'(s)",
+                         Py_TYPE(input_gmic_image_names)->tp_name,
+                         PyUnicode_Type.tp_name);
+
+            return false;
+        }
+    }
+
+    if (input_gmic_images == NULL) {
+        return true;
+    }
+
+    // A/ If a list of images was provided
+    if (PyList_Check(input_gmic_images)) {
+        // Snapshot the list items, so that they stay alive while G'MIC
+        // holds their buffers, even if the list is changed meanwhile from
+        // another thread
+        io->input_images_items = PySequence_List(input_gmic_images);
+        if (io->input_images_items == NULL) {
+            return false;
+        }
+
+        // Check images typing before handing over any buffer
+        for (image_position = 0;
+             image_position < PyList_GET_SIZE(io->input_images_items);
+             image_position++) {
+            current_image =
+                PyList_GET_ITEM(io->input_images_items, image_position);
+            // If gmic_list item type is not a GmicImage
+            if (Py_TYPE(current_image) != (PyTypeObject *)&PyGmicImageType) {
+                PyErr_Format(PyExc_TypeError,
+                             "'%.50s' input object found at "
+                             "position %d in "
+                             "'images' list is not a '%.400s'",
+                             Py_TYPE(current_image)->tp_name, image_position,
+                             PyGmicImageType.tp_name);
+
+                return false;
+            }
+        }
+
+        // Grab images into a proper gmic_list. Buffers are copied, so that
+        // images stay untouched if the run fails. With move_inputs, an
+        // image buffer is moved instead when only the list and our
+        // snapshot reference its GmicImage (GmicImages do not support weak
+        // references), since nobody else can observe that GmicImage being
+        // emptied. It is copied otherwise (eg. an image held by a variable
+        // too, or repeated within the list). Callers must not touch the
+        // list from other threads meanwhile.
+        io->images.assign(PyList_GET_SIZE(io->input_images_items));
+        io->moved_images.assign(io->images.size(), false);
+        io->loaded_buffers.assign(io->images.size(), NULL);
+        io->loaded_checksums.assign(io->images.size(), 0);
+        cimglist_for(io->images, l)
+        {
+            current_image = PyList_GET_ITEM(io->input_images_items, l);
+            bool is_exported =
+                ((PyGmicImage *)current_image)->_exports > 0 ||
+                ((PyGmicImage *)current_image)->_owner_buffer.obj != NULL;
+            bool can_move = move_inputs && Py_REFCNT(current_image) <= 2 &&
+                            !is_exported;
+            swap_gmic_image_into_gmic_list(
+                (PyGmicImage *)current_image, io->images, l, can_move,
+                is_exported ? &io->loaded_checksums[l] : NULL);
+            io->moved_images_count += can_move;
+            io->moved_images[l] = can_move;
+            if (is_exported) {
+                io->loaded_buffers[l] = io->images[l]._data;
+            }
+        }
+    }
+    // B/ Else if a single GmicImage was provided
+    else if (Py_TYPE(input_gmic_images) == (PyTypeObject *)&PyGmicImageType) {
+        io->images.assign(1);
+        // The input buffer is copied, so that the GmicImage stays
+        // untouched if the command fails or removes it. The result comes
+        // back without any copy.
+        PyGmicImage *image = (PyGmicImage *)input_gmic_images;
+        bool is_exported =
+            image->_exports > 0 || image->_owner_buffer.obj != NULL;
+        io->loaded_checksums.assign(1, 0);
+        swap_gmic_image_into_gmic_list(
+            image, io->images, 0, false,
+            is_exported ? &io->loaded_checksums[0] : NULL);
+        io->loaded_buffers.assign(1, is_exported ? io->images[0]._data
+                                                 : (const T *)NULL);
+    }
+    // Else if provided 'images' type is unknown, raise Error
+    else {
+        PyErr_Format(PyExc_TypeError,
+                     "'%.50s' 'images' parameter must be a "
+                     "'%.400s', or list "
+                     "of either '%.400s'(s)",
+                     Py_TYPE(input_gmic_images)->tp_name,
+                     PyGmicImageType.tp_name, PyGmicImageType.tp_name);
+
+        return false;
+    }
+
+    return true;
+}
+
+/* Bring a resulting image back into the input GmicImage found at a given
+ * position, like gmicpy_store_gmic_list_item_into_gmic_image(). Exported or
+ * owner-backed inputs whose buffer G'MIC kept in place (same pointer and
+ * dimensions) with the same pixels checksum as when they were copied in are
+ * skipped, instead of being copied back into their buffer. Returns false,
+ * leaving the GmicImage untouched, if its exported buffer cannot fit the
+ * result. */
+static bool
+gmicpy_run_io_store_image(gmicpy_run_io *io, int l, int position,
+                          PyGmicImage *image)
+{
+    gmic_image<T> &result = io->images[l];
+
+    if ((image->_exports > 0 || image->_owner_buffer.obj != NULL) &&
+        position < (int)io->loaded_buffers.size() &&
+        io->loaded_buffers[position] != NULL &&
+        result._data == io->loaded_buffers[position] &&
+        gmicpy_gmic_image_has_same_dimensions(result, *image->_gmic_image) &&
+        gmicpy_pixels_checksum(result) == io->loaded_checksums[position]) {
+        result.assign();
+        io->untouched_images_count++;
+        return true;
+    }
+
+    return gmicpy_store_gmic_list_item_into_gmic_image(io->images, l, image);
+}
+
+/* Bring G'MIC's resulting gmic_lists back into the 'images' and
+ * 'image_names' run parameters. If the run failed (with its Python exception
+ * set), parameters are left untouched, unless buffers were moved into G'MIC:
+ * those must still come back to Python, so an images list is then refilled
+ * from the gmic_list as it was left at the time of error. Returns false with
+ * a Python exception set on failure. */
+static bool
+gmicpy_run_io_store(gmicpy_run_io *io, bool has_run_failed)
+{
+    PyObject *input_gmic_images = io->input_gmic_images;
+    PyObject *input_gmic_image_names = io->input_gmic_image_names;
+    PyObject *error_type = NULL;
+    PyObject *error_value = NULL;
+    PyObject *error_traceback = NULL;
+    PyObject *result_images = NULL;
+    std::set<PyObject *> stored_images;
+
+    if (input_gmic_images == NULL ||
+        (has_run_failed && io->moved_images_count == 0)) {
+        return !has_run_failed;
+    }
+
+    // A/ If a list of images was provided
+    if (PyList_Check(input_gmic_images)) {
+        if (has_run_failed) {
+            PyErr_Fetch(&error_type, &error_value, &error_traceback);
+        }
+
+        // Bring the results back into the Python world, in the same list.
+        // A result goes into the GmicImage at its position in the input
+        // list, so that references to it held elsewhere see the result,
+        // unless that GmicImage already got an earlier result or its
+        // exported buffer cannot fit it. On errors, only GmicImages whose
+        // buffers were moved into G'MIC get them back, others are left
+        // untouched. Results beyond the input images get new GmicImages.
+        result_images = PyList_New(io->images.size());
+        if (result_images == NULL) {
+            Py_XDECREF(error_type);
+            Py_XDECREF(error_value);
+            Py_XDECREF(error_traceback);
+            return false;
+        }
+        cimglist_for(io->images, l)
+        {
+            PyObject *result_image = NULL;
+            int position = io->output_positions.empty()
+                               ? l
+                               : io->output_positions[l];
+            if (io->input_images_items != NULL &&
+                position < PyList_GET_SIZE(io->input_images_items) &&
+                (!has_run_failed || io->moved_images[position])) {
+                result_image =
+                    PyList_GET_ITEM(io->input_images_items, position);
+                if (stored_images.count(result_image) > 0 ||
+                    !gmicpy_run_io_store_image(io, l, position,
+                                               (PyGmicImage *)result_image)) {
+                    result_image = NULL;
+                }
+                else {
+                    stored_images.insert(result_image);
+                    Py_INCREF(result_image);
+                }
+            }
+            // Each new GmicImage takes over its result buffer without
+            // copying it
+            if (result_image == NULL) {
+                result_image =
+                    new_gmic_image_from_gmic_list_item(io->images, l);
+            }
+            if (result_image == NULL) {
+                Py_DECREF(result_images);
+                Py_XDECREF(error_type);
+                Py_XDECREF(error_value);
+                Py_XDECREF(error_traceback);
+                PyErr_Format(PyExc_RuntimeError,
+                             "Could not initialize GmicImage for "
+                             "appending "
+                             "it to provided 'images' parameter list.");
+                return false;
+            }
+            PyList_SET_ITEM(result_images, l, result_image);
+        }
+        // Replace the input list's items at once (same list reference)
+        PyList_SetSlice(input_gmic_images, 0,
+                        PyList_GET_SIZE(input_gmic_images), result_images);
+        Py_DECREF(result_images);
+        Py_CLEAR(io->input_images_items);
+
+        if (has_run_failed) {
+            PyErr_Restore(error_type, error_value, error_traceback);
+            return false;
+        }
+    }
+    // B/ Else if a single GmicImage was provided, it is left untouched on
+    // errors
+    else if (has_run_failed) {
+        return false;
+    }
+    // Alter the original image only if the gmic_image list has not been
+    // downsized to 0 elements this may happen with eg. a rm[0] G'MIC command
+    // We must prevent this, because a 'core dumped' happens otherwise
+    else if (io->images.size() > 0) {
+        // An exported buffer (eg. viewed by a memoryview or numpy array)
+        // must stay in place, so results are copied into it
+        if (!gmicpy_run_io_store_image(
+                io, 0,
+                io->output_positions.empty() ? 0 : io->output_positions[0],
+                (PyGmicImage *)input_gmic_images)) {
+            PyErr_Format(PyExc_BufferError,
+                         "'%.50s' 'images' single-element parameter "
+                         "cannot change dimensions while its buffer is "
+                         "exported (eg. to a memoryview or a numpy "
+                         "array). It is left untouched.",
+                         Py_TYPE(input_gmic_images)->tp_name);
+            return false;
+        }
+    }
+    else {
+        PyErr_Format(PyExc_RuntimeError,
+                     "'%.50s' 'images' single-element parameter "
+                     "was removed by your G\'MIC command. It was "
+                     "probably emptied, your optional "
+                     "'image_names' list is untouched.",
+                     Py_TYPE(input_gmic_images)->tp_name,
+                     PyGmicImageType.tp_name, PyGmicImageType.tp_name);
+
+        return false;
+    }
+
+    // If a correctly-typed image names parameter was provided,
+    // even if wrongly typed, let us update its Python object
+    // in place, to mirror any kind of changes that may have
+    // taken place in the gmic_list of image names
+    if (input_gmic_image_names != NULL) {
+        // i) If a list parameter was provided
+        if (PyList_Check(input_gmic_image_names)) {
+            // First empty the input Python image names list
+            PySequence_DelSlice(input_gmic_image_names, 0,
+                                PySequence_Length(input_gmic_image_names));
+            // Add image names from the Gmic List of names
+            cimglist_for(io->image_names, l)
+            {
+                PyObject *image_name =
+                    PyUnicode_FromString(io->image_names[l]);
+                PyList_Append(input_gmic_image_names, image_name);
+                Py_XDECREF(image_name);
+            }
+        }
+        // ii) If a str parameter was provided
+        // Because of Python's string immutability, we will not
+        // change the input string's content here :) :/
+    }
+
+    return true;
+}
+
+/* Parse the 'outputs' run parameter, either an int, a sequence of ints or a
+ * G'MIC-like selection string (eg. "[0,-1]" or "0-2,-1"), into ranges of
+ * possibly negative positions. Returns false with a Python exception set
+ * on failure. */
+static bool
+gmicpy_parse_outputs(PyObject *input_outputs,
+                     std::vector<std::pair<long, long> > &ranges)
+{
+    PyObject *outputs_sequence = NULL;
+
+    if (PyUnicode_Check(input_outputs)) {
+        const char *selection = PyUnicode_AsUTF8(input_outputs);
+        const char *end = selection + strlen(selection);
+        char *next = NULL;
+
+        if (*selection == '[' && end > selection && end[-1] == ']') {
+            selection++;
+            end--;
+        }
+        while (selection < end) {
+            long from = strtol(selection, &next, 10);
+            long to = from;
+            if (next == selection) {
+                break;
+            }
+            selection = next;
+            // G'MIC-like range, eg. "0--1" for all images
+            if (*selection == '-') {
+                to = strtol(++selection, &next, 10);
+                if (next == selection) {
+                    break;
+                }
+                selection = next;
+            }
+            ranges.push_back(std::make_pair(from, to));
+            if (*selection == ',') {
+                selection++;
+            }
+            else if (selection != end) {
+                break;
+            }
+        }
+        if (selection != end || ranges.empty()) {
+            PyErr_Format(GmicException,
+                         "'outputs' parameter '%s' is not a selection of "
+                         "image positions (eg. '[0,-1]' or '0-2').",
+                         PyUnicode_AsUTF8(input_outputs));
+            return false;
+        }
+        return true;
+    }
+
+    if (PyLong_Check(input_outputs)) {
+        outputs_sequence = PyTuple_Pack(1, input_outputs);
+    }
+    else {
+        outputs_sequence = PySequence_Fast(
+            input_outputs,
+            "'outputs' parameter must be an int, a sequence of ints or a "
+            "selection 'str'.");
+    }
+    if (outputs_sequence == NULL) {
+        return false;
+    }
+    for (Py_ssize_t i = 0; i < PySequence_Fast_GET_SIZE(outputs_sequence);
+         i++) {
+        long position =
+            PyLong_AsLong(PySequence_Fast_GET_ITEM(outputs_sequence, i));
+        if (position == -1 && PyErr_Occurred()) {
+            Py_DECREF(outputs_sequence);
+            return false;
+        }
+        ranges.push_back(std::make_pair(position, position));
+    }
+    Py_DECREF(outputs_sequence);
+
+    return true;
+}
+
+/* Keep only the images selected by the 'outputs' run parameter in G'MIC's
+ * resulting lists, in increasing positions like G'MIC selections. Other
+ * images are freed right away, without ever being brought to Python.
+ * Returns false with an IndexError set, leaving the lists untouched, if a
+ * position is out of range. */
+static bool
+gmicpy_run_io_select_outputs(gmicpy_run_io *io,
+                             const std::vector<std::pair<long, long> > &ranges)
+{
+    long images_count = (long)io->images.size();
+    std::vector<bool> is_selected(images_count, false);
+    gmic_list<T> selected_images;
+    gmic_list<char> selected_image_names;
+
+    for (size_t i = 0; i < ranges.size(); i++) {
+        long from = ranges[i].first < 0 ? ranges[i].first + images_count
+                                        : ranges[i].first;
+        long to = ranges[i].second < 0 ? ranges[i].second + images_count
+                                       : ranges[i].second;
+        if (from < 0 || to >= images_count || from > to) {
+            PyErr_Format(PyExc_IndexError,
+                         "'outputs' parameter selects positions %ld to %ld, "
+                         "out of the %ld resulting images.",
+                         ranges[i].first, ranges[i].second, images_count);
+            return false;
+        }
+        for (long position = from; position <= to; position++) {
+            is_selected[position] = true;
+        }
+    }
+
+    io->output_positions.clear();
+    for (long position = 0; position < images_count; position++) {
+        if (is_selected[position]) {
+            io->output_positions.push_back((int)position);
+        }
+    }
+    selected_images.assign(io->output_positions.size());
+    selected_image_names.assign(io->output_positions.size());
+    for (size_t l = 0; l < io->output_positions.size(); l++) {
+        unsigned int position = io->output_positions[l];
+        selected_images[l].swap(io->images[position]);
+        if (position < io->image_names.size()) {
+            selected_image_names[l].swap(io->image_names[position]);
+        }
+    }
+    // Unselected images go away with the former lists
+    io->images.swap(selected_images);
+    io->image_names.swap(selected_image_names);
+
+    return true;
+}
+
+/* Total size in bytes of a gmic_list's image buffers. */
+static size_t
+gmicpy_gmic_list_bytes(const gmic_list<T> &images)
+{
+    size_t bytes = 0;
+    cimglist_for(images, l) { bytes += images[l].size() * sizeof(T); }
+    return bytes;
+}
+
+static PyObject *
+run_impl(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    char const *keywords[] = {"command",  "images",   "image_names",
+                              "timeout",  "progress", "profile",
+                              "max_memory", "outputs", "move_inputs", NULL};
+    PyObject *input_gmic_images = NULL;
+    PyObject *input_gmic_image_names = NULL;
+    PyObject *input_progress = NULL;
+    PyObject *input_max_memory = NULL;
+    PyObject *input_outputs = NULL;
+    std::vector<std::pair<long, long> > output_ranges;
+    char *commands_line = NULL;
+    gmicpy_run_io io;
+    gmicpy_run_options options;
+    gmicpy_run_report report;
+    bool has_run_failed = false;
+    int profile = 0;
+    int move_inputs = 0;
+    // Profiling measures, only reported if 'profile' is True
+    gmicpy_clock::time_point start_time, loaded_time, ran_time, stored_time;
+    size_t start_peak_rss_bytes = 0;
+    Py_ssize_t input_images_count = 0;
+    Py_ssize_t output_images_count = 0;
+    size_t input_bytes = 0;
+    size_t output_bytes = 0;
+#ifdef gmic_py_jupyter_ipython_display
+    static bool no_display_checked = false;
+    static bool no_display_available = false;
+    PyObject *commands_line_display_to_ouput_result = NULL;
+    PyObject *ipython_matplotlib_display_result = NULL;
+#endif
+    if (!PyArg_ParseTupleAndKeywords(
+            args, kwargs, "s|OO$dOpOOp", (char **)keywords, &commands_line,
+            &input_gmic_images, &input_gmic_image_names, &options.timeout,
+            &input_progress, &profile, &input_max_memory, &input_outputs,
+            &move_inputs)) {
+        return NULL;
+    }
+    if (input_outputs != NULL && input_outputs != Py_None &&
+        !gmicpy_parse_outputs(input_outputs, output_ranges)) {
+        return NULL;
+    }
+    if (!gmicpy_parse_max_memory(input_max_memory,
+                                 ((PyGmic *)self)->_max_memory,
+                                 &options.max_memory)) {
+        return NULL;
+    }
+    if (!gmicpy_run_options_set_progress(&options, input_progress)) {
+        return NULL;
+    }
+    start_time = gmicpy_clock::now();
+    if (profile) {
+        start_peak_rss_bytes = gmicpy_peak_rss_bytes();
+    }
+
+    try {
+#ifdef gmic_py_jupyter_ipython_display
+        // Use a special way of displaying images only if the OS's display
+        // is not available
+        if (!no_display_checked) {
+            no_display_checked = true;
+            no_display_available = (getenv("DISPLAY") == NULL);
+            if (no_display_available) {
+                PySys_WriteStdout("gmic-py: Working in display-less mode.\n");
+            }
+        }
+
+        if (no_display_available) {
+            // Provide a fallback for gmic "display" command (without
+            // supporting arguments) The idea is to replace all
+            // occurences of "display" by "display output someprefix.png"
+            commands_line_display_to_ouput_result =
+                gmic_py_str_replace_display_to_output(commands_line,
+                                                      (char *)".png");
+            if (commands_line_display_to_ouput_result == NULL) {
+                // Pass exception upwards
+                gmicpy_run_options_clear(&options);
+                return NULL;
+            }
+            commands_line = (char *)PyUnicode_AsUTF8(
+                PyList_GetItem(commands_line_display_to_ouput_result, 0));
+        }
+#endif
+
+        if (!gmicpy_run_io_load(&io, input_gmic_images,
+                                input_gmic_image_names, move_inputs)) {
+            gmicpy_run_io_clear(&io);
+            gmicpy_run_options_clear(&options);
+            return NULL;
+        }
+
+        loaded_time = gmicpy_clock::now();
+        if (profile) {
+            input_images_count = io.images.size();
+            input_bytes = gmicpy_gmic_list_bytes(io.images);
+        }
+
+        // Process images and names
+        has_run_failed =
+            !PyGmic_run_without_gil((PyGmic *)self, commands_line, io.images,
+                                    io.image_names, options, report);
+
+        // On errors, all images come back so that none is lost
+        if (!has_run_failed && input_outputs != NULL &&
+            input_outputs != Py_None &&
+            !gmicpy_run_io_select_outputs(&io, output_ranges)) {
+            has_run_failed = true;
+        }
+
+        ran_time = gmicpy_clock::now();
+        if (profile) {
+            output_images_count = io.images.size();
+            output_bytes = gmicpy_gmic_list_bytes(io.images);
+        }
+
+        if (!gmicpy_run_io_store(&io, has_run_failed)) {
+            gmicpy_run_io_clear(&io);
+            gmicpy_run_options_clear(&options);
+            return NULL;
+        }
+        stored_time = gmicpy_clock::now();
+
+        gmicpy_run_io_clear(&io);
+        gmicpy_run_options_clear(&options);
+    }
+    catch (gmic_exception &e) {
+        gmicpy_run_io_clear(&io);
+        gmicpy_run_options_clear(&options);
+        PyErr_SetString(GmicException, e.what());
+        return NULL;
+    }
+    catch (std::exception &e) {
+        gmicpy_run_io_clear(&io);
+        gmicpy_run_options_clear(&options);
+        PyErr_SetString(GmicException, e.what());
+        return NULL;
+    }
+#ifdef gmic_py_jupyter_ipython_display
+    // Use a special way of displaying only if the OS's display is not
+    // available
+    if (no_display_available) {
+        // Provide a fallback for gmic "display" command (without
+        // supporting arguments) The idea is to replace all occurences
+        // of "display" by "output someprefix.png display in ipython
+        ipython_matplotlib_display_result =
+            gmic_py_display_with_matplotlib_or_ipython(
+                PyList_GetItem(commands_line_display_to_ouput_result, 1));
+        if (ipython_matplotlib_display_result == NULL) {
+            // If we are not within a IPython environment, this is OK
+            // Let us just print the exception without throwing it further
+            // This case typically happens in readthedocs.org for gmic-sphinx
+            PyErr_Print();
+        }
+    }
+    Py_XDECREF(commands_line_display_to_ouput_result);
+    Py_XDECREF(ipython_matplotlib_display_result);
+#endif
+
+    if (profile) {
+        size_t peak_rss_bytes = gmicpy_peak_rss_bytes();
+        return Py_BuildValue(
+            "{s:d,s:d,s:d,s:d,s:d,s:n,s:n,s:n,s:n,s:n,s:n,s:i,s:O,s:n,s:n,"
+            "s:n}",
+            "total_seconds",
+            gmicpy_seconds_between(start_time, stored_time), "load_seconds",
+            gmicpy_seconds_between(start_time, loaded_time),
+            "lock_wait_seconds", report.lock_wait_seconds, "run_seconds",
+            report.run_seconds, "store_seconds",
+            gmicpy_seconds_between(ran_time, stored_time), "input_images",
+            input_images_count, "moved_images", io.moved_images_count,
+            "input_bytes", (Py_ssize_t)input_bytes, "output_images",
+            output_images_count, "output_bytes", (Py_ssize_t)output_bytes,
+            "untouched_images", io.untouched_images_count, "openmp_threads",
+            gmicpy_openmp_threads(), "monitor_thread",
+            report.has_monitor_thread ? Py_True : Py_False, "peak_rss_bytes",
+            (Py_ssize_t)peak_rss_bytes, "peak_rss_growth_bytes",
+            (Py_ssize_t)(peak_rss_bytes - start_peak_rss_bytes),
+            "peak_memory_bytes", (Py_ssize_t)report.peak_memory_bytes);
+    }
+
+    Py_RETURN_NONE;
+}
+
+/* Gmic.run() variant returning its 'images' parameter once G'MIC is done
+ * with it (or None). Used as the job of worker threads. */
+static PyObject *
+run_impl_returning_images(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    PyObject *input_gmic_images = NULL;
+    PyObject *run_result = NULL;
+
+    if (PyTuple_GET_SIZE(args) > 1) {
+        input_gmic_images = PyTuple_GET_ITEM(args, 1);
+    }
+    else if (kwargs != NULL) {
+        input_gmic_images = PyDict_GetItemString(kwargs, "images");
+    }
+    input_gmic_images = input_gmic_images != NULL ? input_gmic_images : Py_None;
+    Py_INCREF(input_gmic_images);
+
+    run_result = run_impl(self, args, kwargs);
+    if (run_result == NULL) {
+        Py_DECREF(input_gmic_images);
+        return NULL;
+    }
+    Py_DECREF(run_result);
+
+    return input_gmic_images;
+}
+
+// Defined with the abort binding below
+static PyObject *
+PyGmic_abort(PyGmic *self, PyObject *args);
+
+/* Gmic.run_async() future completion, scheduled on the event loop's thread
+ * with (future, result, exception) arguments. Futures cancelled meanwhile
+ * are left as is. */
+static PyObject *
+gmicpy_run_async_complete(PyObject *unused, PyObject *args)
+{
+    PyObject *future = NULL;
+    PyObject *result = NULL;
+    PyObject *exception = NULL;
+    PyObject *done = NULL;
+    int is_done = 0;
+
+    if (!PyArg_ParseTuple(args, "OOO", &future, &result, &exception)) {
+        return NULL;
+    }
+    if (!(done = PyObject_CallMethod(future, "done", NULL))) {
+        return NULL;
+    }
+    is_done = PyObject_IsTrue(done);
+    Py_DECREF(done);
+    if (is_done < 0) {
+        return NULL;
+    }
+    if (is_done) {
+        Py_RETURN_NONE;
+    }
+    if (exception != Py_None) {
+        return PyObject_CallMethod(future, "set_exception", "O", exception);
+    }
+    return PyObject_CallMethod(future, "set_result", "O", result);
+}
+
+/* Gmic.run_async() future done-callback, bound to the Gmic instance:
+ * cancelling the future aborts the run. */
+static PyObject *
+gmicpy_run_async_done(PyObject *self, PyObject *future)
+{
+    PyObject *cancelled = PyObject_CallMethod(future, "cancelled", NULL);
+    int is_cancelled = 0;
+
+    if (cancelled == NULL) {
+        return NULL;
+    }
+    is_cancelled = PyObject_IsTrue(cancelled);
+    Py_DECREF(cancelled);
+    if (is_cancelled < 0) {
+        return NULL;
+    }
+    if (is_cancelled) {
+        return PyGmic_abort((PyGmic *)self, NULL);
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyMethodDef gmicpy_run_async_complete_def = {
+    "_run_async_complete", (PyCFunction)gmicpy_run_async_complete,
+    METH_VARARGS, NULL};
+static PyMethodDef gmicpy_run_async_done_def = {
+    "_run_async_done", (PyCFunction)gmicpy_run_async_done, METH_O, NULL};
+
+/* Gmic.run_async() native thread body: run self._run(*args, **kwargs),
+ * which releases the GIL while G'MIC runs, then hand its outcome over to
+ * the event loop. Steals all references. */
+static void
+gmicpy_run_async_work(PyObject *run_method, PyObject *args,
+                      PyObject *kwargs, PyObject *loop, PyObject *future)
+{
+    PyGILState_STATE gil_state = PyGILState_Ensure();
+    PyObject *result = NULL;
+    PyObject *error_type = NULL;
+    PyObject *error_value = NULL;
+    PyObject *error_traceback = NULL;
+    PyObject *complete = NULL;
+    PyObject *scheduled = NULL;
+    PyObject *cancelled = PyObject_CallMethod(future, "cancelled", NULL);
+
+    // Futures cancelled before the run started skip it
+    if (cancelled != NULL && !PyObject_IsTrue(cancelled)) {
+        result = PyObject_Call(run_method, args, kwargs);
+    }
+    else if (cancelled != NULL) {
+        result = Py_None;
+        Py_INCREF(result);
+    }
+    Py_XDECREF(cancelled);
+    if (result == NULL) {
+        PyErr_Fetch(&error_type, &error_value, &error_traceback);
+        PyErr_NormalizeException(&error_type, &error_value,
+                                 &error_traceback);
+        if (error_traceback != NULL) {
+            PyException_SetTraceback(error_value, error_traceback);
+        }
+    }
+    complete = PyCFunction_New(&gmicpy_run_async_complete_def, NULL);
+    if (complete != NULL) {
+        scheduled = PyObject_CallMethod(
+            loop, "call_soon_threadsafe", "OOOO", complete, future,
+            result != NULL ? result : Py_None,
+            error_value != NULL ? error_value : Py_None);
+    }
+    // Eg. if the loop got closed meanwhile
+    if (scheduled == NULL) {
+        PyErr_WriteUnraisable(loop);
+    }
+
+    Py_XDECREF(scheduled);
+    Py_XDECREF(complete);
+    Py_XDECREF(result);
+    Py_XDECREF(error_type);
+    Py_XDECREF(error_value);
+    Py_XDECREF(error_traceback);
+    Py_DECREF(run_method);
+    Py_DECREF(args);
+    Py_XDECREF(kwargs);
+    Py_DECREF(loop);
+    Py_DECREF(future);
+    PyGILState_Release(gil_state);
+}
+
+static PyObject *
+PyGmic_run_async(PyGmic *self, PyObject *args, PyObject *kwargs)
+{
+    PyObject *asyncio_module = NULL;
+    PyObject *loop = NULL;
+    PyObject *run_method = NULL;
+    PyObject *future = NULL;
+    PyObject *done_callback = NULL;
+    PyObject *added = NULL;
+
+    if (!(asyncio_module = PyImport_ImportModule("asyncio"))) {
+        return NULL;
+    }
+    // Raises a RuntimeError if not called from a coroutine or callback
+    loop = PyObject_CallMethod(asyncio_module, "get_running_loop", NULL);
+    Py_DECREF(asyncio_module);
+    if (loop == NULL) {
+        return NULL;
+    }
+
+    run_method = PyObject_GetAttrString((PyObject *)self, "_run");
+    if (run_method != NULL) {
+        future = PyObject_CallMethod(loop, "create_future", NULL);
+    }
+    if (future != NULL) {
+        done_callback =
+            PyCFunction_New(&gmicpy_run_async_done_def, (PyObject *)self);
+    }
+    if (done_callback != NULL) {
+        added = PyObject_CallMethod(future, "add_done_callback", "O",
+                                    done_callback);
+        Py_DECREF(done_callback);
+    }
+    if (added == NULL) {
+        Py_XDECREF(future);
+        Py_XDECREF(run_method);
+        Py_DECREF(loop);
+        return NULL;
+    }
+    Py_DECREF(added);
+
+    // G'MIC runs on a thread of its own rather than on an executor's
+    // worker, which would stay blocked for the whole run. The thread owns
+    // a reference to each object it uses.
+    Py_INCREF(args);
+    Py_XINCREF(kwargs);
+    Py_INCREF(future);
+    try {
+        std::thread(gmicpy_run_async_work, run_method, args, kwargs, loop,
+                    future)
+            .detach();
+    }
+    catch (std::exception &e) {
+        Py_DECREF(run_method);
+        Py_DECREF(args);
+        Py_XDECREF(kwargs);
+        Py_DECREF(loop);
+        Py_DECREF(future);
+        Py_DECREF(future);
+        PyErr_SetString(GmicException, e.what());
+        return NULL;
+    }
+
+    return future;
+}
+
+#ifdef gmic_py_numpy
+/**
+ * Predictable Python 3.x 'numpy' module importer.
+ */
+PyObject *
+import_numpy_module()
+{
+    PyObject *numpy_module = PyImport_ImportModule("numpy");
+
+    // exit raising numpy_module import exception
+    if (!numpy_module) {
+        PyErr_Clear();
+        return PyErr_Format(GmicException,
+                            "The 'numpy' module cannot be imported. Is it "
+                            "installed or in your Python path?");
+    }
+
+    return numpy_module;
+}
+
+/*
+ * GmicImage class method from_numpy_helper().
+ * This factory class method generates a G'MIC Image from a
+ * numpy.ndarray.
+ *
+ *  GmicImage.from_numpy_helper(obj: numpy.ndarray, deinterleave=True,
+ * permute="xyzc": bool) -> GmicImage
+ */
+static PyObject *
+PyGmicImage_from_numpy_helper(PyObject *cls, PyObject *args, PyObject *kwargs)
+{
+    PyObject *py_arg_deinterleave = NULL;
+    PyObject *py_arg_deinterleave_default =
+        Py_True;  // Will deinterleave the incoming numpy.ndarray by default
+    PyObject *py_arg_ndarray = NULL;
+    PyObject *ndarray_type = NULL;
+    unsigned int ndarray_ndim = 0;
+    PyObject *ndarray_dtype = NULL;
+    PyObject *ndarray_dtype_kind = NULL;
+    PyObject *float32_ndarray = NULL;
+    PyObject *ndarray_as_3d_unsqueezed_view = NULL;
+    PyObject *ndarray_as_3d_unsqueezed_view_expanded_dims = NULL;
+    PyObject *ndarray_shape_tuple = NULL;
+    unsigned int _width = 1, _height = 1, _depth = 1, _spectrum = 1;
+    PyObject *numpy_module = NULL;
+    bool is_deinterleave = true;
+    char const *keywords[] = {"numpy_array", "deinterleave", "permute",
+                              "copy", NULL};
+    PyGmicImage *py_gmicimage_to_fill = NULL;
+    char *arg_permute = NULL;
+    int arg_copy = 1;  // Copies pixels by default, for backward compatibility
+    Py_buffer ndarray_buffer;
+
+    numpy_module = import_numpy_module();
+    if (!numpy_module)
+        return NULL;
+
+    ndarray_type = PyObject_GetAttrString(numpy_module, "ndarray");
+
+    if (!PyArg_ParseTupleAndKeywords(
+            args, kwargs, (const char *)"O!|O!sp", (char **)keywords,
+            (PyTypeObject *)ndarray_type, &py_arg_ndarray, &PyBool_Type,
+            &py_arg_deinterleave, &arg_permute, &arg_copy))
+        return NULL;
+
+    py_arg_deinterleave = py_arg_deinterleave == NULL
+                              ? py_arg_deinterleave_default
+                              : py_arg_deinterleave;
+
+    Py_XINCREF(py_arg_ndarray);
+    Py_XINCREF(py_arg_deinterleave);
+
+    // Get number of dimensions and ensure we are >=1D <=4D
+    ndarray_ndim = (unsigned int)PyLong_AsSize_t(
+        PyObject_GetAttrString(py_arg_ndarray, "ndim"));
+    if (ndarray_ndim < 1 || ndarray_ndim > 4) {
+        PyErr_Format(GmicException,
+                     "Provided 'data' of type 'numpy.ndarray' must be between "
+                     "1D and 4D ('data.ndim'=%d).",
+                     ndarray_ndim);
+        return NULL;
+    }
+
+    // Get input ndarray.dtype and prevent non-integer/float/bool data
+    // types to be processed
+    ndarray_dtype = PyObject_GetAttrString(py_arg_ndarray, "dtype");
+    // Ensure dtype kind is a number we can convert (from dtype values
+    // here:
+    // https://numpy.org/doc/1.18/reference/generated/numpy.dtype.kind.html#numpy.dtype.kind)
+    ndarray_dtype_kind = PyObject_GetAttrString(ndarray_dtype, "kind");
+    if (strchr("biuf", (PyUnicode_ReadChar(ndarray_dtype_kind,
+                                           (Py_ssize_t)0))) == NULL) {
+        PyErr_Format(PyExc_TypeError,
+                     "Parameter 'data' of type 'numpy.ndarray' does not "
+                     "contain numbers ie. its 'dtype.kind'(=%U) is not one of "
+                     "'b', 'i', 'u', 'f'.",
+                     ndarray_dtype_kind);
+        // TODO pytest this
+        return NULL;
+    }
+
+    // Get unsqueezed shape of numpy array -> GmicImage width, height,
+    // depth, spectrum Getting a shape with the most axes from array:
+    // https://docs.scipy.org/doc/numpy-1.17.0/reference/generated/numpy.atleast_3d.html#numpy.atleast_3d
+    // Adding a depth axis using numpy.expand_dims:
+    // https://docs.scipy.org/doc/numpy-1.17.0/reference/generated/numpy.expand_dims.html
+    // (numpy tends to squeeze dimensions when calling the standard
+    // array().shape, we circumvent this)
+    ndarray_as_3d_unsqueezed_view =
+        PyObject_CallMethod(numpy_module, "atleast_3d", "O", py_arg_ndarray);
+    ndarray_as_3d_unsqueezed_view_expanded_dims = PyObject_CallMethod(
+        numpy_module, "expand_dims", "OI", ndarray_as_3d_unsqueezed_view,
+        2);  // Adding z axis if absent
+    // After this the shape should be (w, h, 1, 3)
+    ndarray_shape_tuple = PyObject_GetAttrString(
+        ndarray_as_3d_unsqueezed_view_expanded_dims, "shape");
+    _height =
+        (unsigned int)PyLong_AsSize_t(PyTuple_GetItem(ndarray_shape_tuple, 0));
+    _width =
+        (unsigned int)PyLong_AsSize_t(PyTuple_GetItem(ndarray_shape_tuple, 1));
+    _depth =
+        (unsigned int)PyLong_AsSize_t(PyTuple_GetItem(ndarray_shape_tuple, 2));
+    _spectrum =
+        (unsigned int)PyLong_AsSize_t(PyTuple_GetItem(ndarray_shape_tuple, 3));
+
+    // A float32 C-contiguous writable array already laid out as G'MIC
+    // pixels (ie. not to be deinterleaved, or single-channel) can be
+    // shared rather than copied. The GmicImage then holds a buffer export
+    // on the array until a run reallocates its pixels.
+    if (!arg_copy &&
+        (!PyObject_IsTrue(py_arg_deinterleave) || _spectrum == 1)) {
+        if (PyObject_GetBuffer(py_arg_ndarray, &ndarray_buffer,
+                               PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS |
+                                   PyBUF_FORMAT) == 0) {
+            if (strcmp(ndarray_buffer.format, "f") == 0 &&
+                ndarray_buffer.len ==
+                    (Py_ssize_t)((size_t)_width * _height * _depth *
+                                 _spectrum * sizeof(T))) {
+                py_gmicimage_to_fill = (PyGmicImage *)PyGmicImageType.tp_alloc(
+                    &PyGmicImageType, 0);
+            }
+            if (py_gmicimage_to_fill != NULL) {
+                py_gmicimage_to_fill->_gmic_image->assign(
+                    (T *)ndarray_buffer.buf, _width, _height, _depth,
+                    _spectrum, true);
+                py_gmicimage_to_fill->_owner_buffer = ndarray_buffer;
+            }
+            else {
+                PyBuffer_Release(&ndarray_buffer);
+            }
+        }
+        // Incompatible arrays (eg. read-only or strided) are copied
+        PyErr_Clear();
+    }
+
+    if (py_gmicimage_to_fill != NULL) {
+        Py_XDECREF(py_arg_ndarray);
+        Py_XDECREF(py_arg_deinterleave);
+        Py_XDECREF(ndarray_dtype);
+        Py_XDECREF(ndarray_dtype_kind);
+        Py_XDECREF(ndarray_as_3d_unsqueezed_view);
+        Py_XDECREF(ndarray_as_3d_unsqueezed_view_expanded_dims);
+        Py_XDECREF(ndarray_shape_tuple);
+        Py_XDECREF(ndarray_type);
+        Py_XDECREF(numpy_module);
+
+        return (PyObject *)py_gmicimage_to_fill;
+    }
+
+    // Pixel values of common C types are cast into G'MIC's float32 while
+    // being copied, in one pass. Other types, as well as non-contiguous
+    // matrices, first go through a float32 contiguous copy.
+    if (PyObject_GetBuffer(ndarray_as_3d_unsqueezed_view, &ndarray_buffer,
+                           PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == 0) {
+        if (strlen(ndarray_buffer.format) != 1 ||
+            strchr("?bBhHiIlLqQfd", ndarray_buffer.format[0]) == NULL) {
+            PyBuffer_Release(&ndarray_buffer);
+            ndarray_buffer.obj = NULL;
+        }
+    }
+    else {
+        PyErr_Clear();
+        ndarray_buffer.obj = NULL;
+    }
+    if (ndarray_buffer.obj == NULL) {
+        float32_ndarray = PyObject_CallMethod(
+            numpy_module, "ascontiguousarray", "OO",
+            ndarray_as_3d_unsqueezed_view,
+            PyObject_GetAttrString(numpy_module, "float32"));
+        if (float32_ndarray == NULL ||
+            PyObject_GetBuffer(float32_ndarray, &ndarray_buffer,
+                               PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0) {
+            Py_XDECREF(float32_ndarray);
+            return NULL;
+        }
+    }
+
+    // Every pixel gets overwritten, so the buffer is not zero-filled first
+    py_gmicimage_to_fill =
+        (PyGmicImage *)PyGmicImageType.tp_alloc(&PyGmicImageType, 0);
+    if (py_gmicimage_to_fill == NULL) {
+        PyBuffer_Release(&ndarray_buffer);
+        Py_XDECREF(float32_ndarray);
+        return NULL;
+    }
+    try {
+        py_gmicimage_to_fill->_gmic_image->assign(_width, _height, _depth,
+                                                  _spectrum);
+    }
+    catch (...) {
+        PyErr_Format(PyExc_MemoryError,
+                     "Allocation error in "
+                     "GmicImage::assign(_width=%d,_height=%d,_depth=%d,_"
+                     "spectrum=%d), "
+                     "are you requesting too much memory (%d bytes)?",
+                     _width, _height, _depth, _spectrum,
+                     _width * _height * _depth * _spectrum * sizeof(T));
+        Py_DECREF(py_gmicimage_to_fill);
+        PyBuffer_Release(&ndarray_buffer);
+        Py_XDECREF(float32_ndarray);
+        return NULL;
+    }
+
+    is_deinterleave = PyObject_IsTrue(py_arg_deinterleave);
+    gmicpy_import_pixels_from(ndarray_buffer.buf, ndarray_buffer.format[0],
+                              *py_gmicimage_to_fill->_gmic_image,
+                              is_deinterleave);
+    PyBuffer_Release(&ndarray_buffer);
+
+    Py_XDECREF(py_arg_ndarray);
+    Py_XDECREF(py_arg_deinterleave);
+    Py_XDECREF(ndarray_dtype);
+    Py_XDECREF(ndarray_dtype_kind);
+    Py_XDECREF(float32_ndarray);
+    Py_XDECREF(ndarray_as_3d_unsqueezed_view);
+    Py_XDECREF(ndarray_as_3d_unsqueezed_view_expanded_dims);
+    Py_XDECREF(ndarray_shape_tuple);
+    Py_XDECREF(ndarray_type);
+    Py_XDECREF(numpy_module);
+
+    return (PyObject *)py_gmicimage_to_fill;
+}
+
+static PyObject *
+PyGmicImage_from_numpy(PyObject *cls, PyObject *args, PyObject *kwargs)
+{
+    char const *keywords[] = {"numpy_array", "copy", NULL};
+    PyObject *arg_np_array = NULL;  // No defaults
+    PyObject *a = NULL;
+    PyObject *kw = NULL;
+    int arg_copy = 1;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|p", (char **)keywords,
+                                     &arg_np_array, &arg_copy)) {
+        return NULL;
+    }
+    a = PyTuple_New(0);
+    kw = PyDict_New();
+    PyDict_SetItemString(kw, "numpy_array", arg_np_array);
+    PyDict_SetItemString(kw, "deinterleave", Py_True);
+    PyDict_SetItemString(kw, "copy", arg_copy ? Py_True : Py_False);
+
+    return PyObject_Call(PyObject_GetAttrString(cls, "from_numpy_helper"), a,
+                         kw);
+}
+
+static PyObject *
+PyGmicImage_to_numpy(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    char const *keywords[] = {"copy", NULL};
+    PyObject *a = NULL;
+    PyObject *kw = NULL;
+    int arg_copy = 1;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|p", (char **)keywords,
+                                     &arg_copy)) {
+        return NULL;
+    }
+
+    a = PyTuple_New(0);
+    kw = PyDict_New();
+    PyDict_SetItemString(kw, "interleave", Py_True);
+    PyDict_SetItemString(kw, "copy", arg_copy ? Py_True : Py_False);
+
+    return PyObject_Call(PyObject_GetAttrString(self, "to_numpy_helper"), a,
+                         kw);
+}
+
+static PyObject *
+PyGmicImage_from_skimage(PyObject *cls, PyObject *args, PyObject *kwargs)
+{
+    char const *keywords[] = {"scikit_image", NULL};
+    PyObject *py_permute_str = NULL;
+    PyObject *arg_scikit_image = NULL;  // No defaults
+    PyObject *a = NULL;
+    PyObject *kw = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", (char **)keywords,
+                                     &arg_scikit_image)) {
+        return NULL;
+    }
+    a = PyTuple_New(0);
+    kw = PyDict_New();
+    PyDict_SetItemString(kw, "numpy_array", arg_scikit_image);
+    PyDict_SetItemString(kw, "deinterleave", Py_True);
+    py_permute_str = PyUnicode_FromString("zyxc");
+    PyDict_SetItemString(kw, "permute", py_permute_str);
+
+    return PyObject_Call(PyObject_GetAttrString(cls, "from_numpy_helper"), a,
+                         kw);
+}
+
+static PyObject *
+PyGmicImage_to_skimage(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    PyObject *a = NULL;
+    PyObject *kw = NULL;
+    PyObject *py_permute_str = NULL;
+
+    a = PyTuple_New(0);
+    kw = PyDict_New();
+    PyDict_SetItemString(kw, "interleave", Py_True);
+    py_permute_str = PyUnicode_FromString("zyxc");
+    PyDict_SetItemString(kw, "permute", py_permute_str);
+
+    return PyObject_Call(PyObject_GetAttrString(self, "to_numpy_helper"), a,
+                         kw);
+}
+
+// End of ifdef gmic_py_numpy
+#endif
+
+//------- PIL IMAGES CONVERSION ----------//
+
+/* PIL image modes whose raw bytes are converted without numpy, as packed
+ * pixels with channel values of a given Python buffer format. */
+struct gmicpy_pil_mode {
+    const char *name;
+    unsigned int spectrum;
+    char format;
+    size_t value_size;
+    const char *astype;  // Name of the matching to_PIL() astype type
+};
+
+static const gmicpy_pil_mode gmicpy_pil_modes[] = {
+    {"L", 1, 'B', 1, "uint8"},      {"LA", 2, 'B', 1, "uint8"},
+    {"RGB", 3, 'B', 1, "uint8"},    {"RGBA", 4, 'B', 1, "uint8"},
+    {"I;16", 1, 'H', 2, "uint16"},  {"I", 1, 'i', 4, "int32"},
+    {"F", 1, 'f', 4, "float32"}};
+
+/* Find a PIL mode convertible without numpy, or return NULL. */
+static const gmicpy_pil_mode *
+gmicpy_find_pil_mode(const char *name)
+{
+    const uint16_t one = 1;
+    const bool is_little_endian = *(const unsigned char *)&one == 1;
+
+    if (name == NULL) {
+        return NULL;
+    }
+    for (size_t m = 0;
+         m < sizeof(gmicpy_pil_modes) / sizeof(gmicpy_pil_modes[0]); m++) {
+        if (strcmp(gmicpy_pil_modes[m].name, name) == 0) {
+            // I;16 raw bytes are little-endian, other modes' are native
+            if (gmicpy_pil_modes[m].format == 'H' && !is_little_endian) {
+                return NULL;
+            }
+            return &gmicpy_pil_modes[m];
+        }
+    }
+
+    return NULL;
+}
+
+static PyObject *
+PyGmicImage_from_PIL(PyObject *cls, PyObject *args, PyObject *kwargs)
+{
+    char const *keywords[] = {"pil_image", NULL};
+    PyObject *PIL_Image_mod = NULL;
+    PyObject *PIL_Image_Image_class = NULL;
+    PyObject *arg_PIL_image = NULL;  // No defaults
+    PyObject *pil_mode_str = NULL;
+    PyObject *pil_size = NULL;
+    PyObject *pil_bytes = NULL;
+    const gmicpy_pil_mode *pil_mode = NULL;
+    PyGmicImage *image = NULL;
+    unsigned int width = 0, height = 0;
+
+    if (!(PIL_Image_mod = PyImport_ImportModule("PIL.Image"))) {
+        return NULL;
+    }
+
+    PIL_Image_Image_class = PyObject_GetAttrString(PIL_Image_mod, "Image");
+    Py_DECREF(PIL_Image_mod);
+    if (!PIL_Image_Image_class) {
+        return NULL;
+    }
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!", (char **)keywords,
+                                     (PyTypeObject *)PIL_Image_Image_class,
+                                     &arg_PIL_image)) {
+        Py_DECREF(PIL_Image_Image_class);
+        return NULL;
+    }
+    Py_DECREF(PIL_Image_Image_class);
+
+    // Common modes' raw bytes are deinterleaved and cast in one pass
+    pil_mode_str = PyObject_GetAttrString(arg_PIL_image, "mode");
+    if (pil_mode_str != NULL && PyUnicode_Check(pil_mode_str)) {
+        pil_mode = gmicpy_find_pil_mode(PyUnicode_AsUTF8(pil_mode_str));
+    }
+    Py_XDECREF(pil_mode_str);
+    PyErr_Clear();
+    if (pil_mode != NULL) {
+        if (!(pil_size = PyObject_GetAttrString(arg_PIL_image, "size"))) {
+            return NULL;
+        }
+        if (!PyArg_ParseTuple(pil_size, "II", &width, &height)) {
+            Py_DECREF(pil_size);
+            return NULL;
+        }
+        Py_DECREF(pil_size);
+        if (!(pil_bytes =
+                  PyObject_CallMethod(arg_PIL_image, "tobytes", NULL))) {
+            return NULL;
+        }
+        if (!PyBytes_Check(pil_bytes) ||
+            (size_t)PyBytes_GET_SIZE(pil_bytes) !=
+                (size_t)width * height * pil_mode->spectrum *
+                    pil_mode->value_size) {
+            PyErr_Format(GmicException,
+                         "PIL image of mode '%s' and size %ux%u has an "
+                         "unexpected raw bytes length.",
+                         pil_mode->name, width, height);
+            Py_DECREF(pil_bytes);
+            return NULL;
+        }
+        image = (PyGmicImage *)PyGmicImageType.tp_alloc(&PyGmicImageType, 0);
+        if (image == NULL) {
+            Py_DECREF(pil_bytes);
+            return NULL;
+        }
+        try {
+            image->_gmic_image->assign(width, height, 1, pil_mode->spectrum);
+        }
+        catch (...) {
+            PyErr_Format(PyExc_MemoryError,
+                         "Allocation error in "
+                         "GmicImage::assign(_width=%d,_height=%d,_depth=%d,_"
+                         "spectrum=%d), "
+                         "are you requesting too much memory (%d bytes)?",
+                         width, height, 1, pil_mode->spectrum,
+                         width * height * pil_mode->spectrum * sizeof(T));
+            Py_DECREF(image);
+            Py_DECREF(pil_bytes);
+            return NULL;
+        }
+        gmicpy_import_pixels_from(PyBytes_AS_STRING(pil_bytes),
+                                  pil_mode->format, *image->_gmic_image,
+                                  true);
+        Py_DECREF(pil_bytes);
+
+        return (PyObject *)image;
+    }
+
+#ifdef gmic_py_numpy
+    {
+        PyObject *numpy_mod = NULL;
+        PyObject *numpy_intermediate_array = NULL;
+        PyObject *a = NULL;
+        PyObject *kw = NULL;
+
+        if (!(numpy_mod = import_numpy_module())) {
+            return NULL;
+        }
+        numpy_intermediate_array = PyObject_CallFunction(
+            PyObject_GetAttrString(numpy_mod, "array"), "O", arg_PIL_image);
+        Py_DECREF(numpy_mod);
+        if (!numpy_intermediate_array) {
+            return NULL;
+        }
+        a = PyTuple_New(0);
+        kw = PyDict_New();
+        PyDict_SetItemString(kw, "numpy_array", numpy_intermediate_array);
+        PyDict_SetItemString(kw, "deinterleave", Py_True);
+        Py_DECREF(numpy_intermediate_array);
+
+        return PyObject_Call(PyObject_GetAttrString(cls, "from_numpy_helper"),
+                             a, kw);
+    }
+#else
+    PyErr_Format(PyExc_TypeError,
+                 "PIL image mode is not one of L, LA, RGB, RGBA, I;16, I or "
+                 "F, and needs gmic-py to be built with numpy support to be "
+                 "converted.");
+    return NULL;
+#endif
+}
+
+static PyObject *
+PyGmicImage_to_PIL(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    PyObject *PIL_Image_mod = NULL;
+    char const *keywords[] = {"astype", "squeeze_shape", "mode", NULL};
+    PyObject *arg_astype = NULL;         // defaults to numpy.uint8
+    unsigned int arg_squeeze_shape = 1;  // Defaults to true
+    PyObject *arg_mode = NULL;           // Defaults to 'RGB'
+    PyObject *astype_name = NULL;
+    PyObject *pil_bytes = NULL;
+    PyObject *pil_image = NULL;
+    const gmicpy_pil_mode *pil_mode = NULL;
+    gmic_image<T> *image = ((PyGmicImage *)self)->_gmic_image;
+    bool is_direct = false;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O!pO", (char **)keywords,
+                                     &PyType_Type, &arg_astype,
+                                     &arg_squeeze_shape, &arg_mode)) {
+        return NULL;
+    }
+
+    // Squeezed 2D images matching a common mode's channels and type are
+    // interleaved and cast into raw bytes in one pass
+    if (arg_mode == NULL) {
+        pil_mode = gmicpy_find_pil_mode("RGB");
+    }
+    else if (PyUnicode_Check(arg_mode)) {
+        pil_mode = gmicpy_find_pil_mode(PyUnicode_AsUTF8(arg_mode));
+    }
+    if (arg_astype != NULL) {
+        astype_name = PyObject_GetAttrString(arg_astype, "__name__");
+    }
+    is_direct =
+        pil_mode != NULL && arg_squeeze_shape && image->_depth == 1 &&
+        image->_spectrum == pil_mode->spectrum &&
+        (arg_astype == NULL
+             ? strcmp(pil_mode->astype, "uint8") == 0
+             : astype_name != NULL && PyUnicode_Check(astype_name) &&
+                   PyUnicode_CompareWithASCIIString(astype_name,
+                                                    pil_mode->astype) == 0);
+    Py_XDECREF(astype_name);
+    PyErr_Clear();
+    if (is_direct) {
+        if (!(PIL_Image_mod = PyImport_ImportModule("PIL.Image"))) {
+            return NULL;
+        }
+        pil_bytes = PyBytes_FromStringAndSize(
+            NULL, (Py_ssize_t)(image->size() * pil_mode->value_size));
+        if (pil_bytes == NULL) {
+            Py_DECREF(PIL_Image_mod);
+            return NULL;
+        }
+        gmicpy_export_pixels_to(*image, PyBytes_AS_STRING(pil_bytes),
+                                pil_mode->format, GMICPY_PIXELS_INTERLEAVED);
+        pil_image = PyObject_CallMethod(
+            PIL_Image_mod, "frombuffer", "s(II)Ossii", pil_mode->name,
+            image->_width, image->_height, pil_bytes, "raw", pil_mode->name,
+            0, 1);
+        Py_DECREF(pil_bytes);
+        Py_DECREF(PIL_Image_mod);
+
+        return pil_image;
+    }
+
+#ifdef gmic_py_numpy
+    {
+        PyObject *numpy_mod = NULL;
+        PyObject *a = NULL;
+        PyObject *kw = NULL;
+        PyObject *py_permute_str = NULL;
+        PyObject *prePIL_np_array = NULL;
+
+        if (!(numpy_mod = import_numpy_module())) {
+            return NULL;
+        }
+
+        if (!(PIL_Image_mod = PyImport_ImportModule("PIL.Image"))) {
+            return NULL;
+        }
+
+        if (arg_astype == NULL) {
+            arg_astype = PyObject_GetAttrString(numpy_mod, "uint8");
+        }
+        else {
+            Py_INCREF(arg_astype);
+        }
+
+        if (arg_mode == NULL) {
+            arg_mode = PyUnicode_FromString("RGB");
+        }
+        else {
+            Py_INCREF(arg_mode);
+        }
+
+        a = PyTuple_New(0);
+        kw = PyDict_New();
+        PyDict_SetItemString(kw, "interleave", Py_True);
+        PyDict_SetItemString(kw, "astype", arg_astype);
+        if (arg_squeeze_shape) {
+            PyDict_SetItemString(kw, "squeeze_shape", Py_True);
+        }
+        py_permute_str = PyUnicode_FromString("zyxc");
+        PyDict_SetItemString(kw, "permute", py_permute_str);
+
+        prePIL_np_array = PyObject_Call(
+            PyObject_GetAttrString(self, "to_numpy_helper"), a, kw);
+
+        Py_DECREF(numpy_mod);
+        Py_DECREF(py_permute_str);
+        Py_DECREF(kw);
+        Py_DECREF(a);
+        Py_DECREF(arg_astype);
+
+        if (!prePIL_np_array) {
+            Py_DECREF(arg_mode);
+            Py_DECREF(PIL_Image_mod);
+            return NULL;
+        }
+
+        pil_image = PyObject_CallFunction(
+            PyObject_GetAttrString(PIL_Image_mod, "fromarray"), "OO",
+            prePIL_np_array, arg_mode);
+        Py_DECREF(prePIL_np_array);
+        Py_DECREF(arg_mode);
+        Py_DECREF(PIL_Image_mod);
+
+        return pil_image;
+    }
+#else
+    PyErr_Format(PyExc_TypeError,
+                 "Converting a GmicImage of %u channels into a PIL image "
+                 "with this mode and astype needs gmic-py to be built with "
+                 "numpy support.",
+                 image->_spectrum);
+    return NULL;
+#endif
+}
+
+/* A G'MIC commands file (eg. the user's $_path_user one), read once per
+ * process and read again only once changed on disk. */
+struct gmicpy_commands_file {
+    bool exists;
+    time_t mtime;
+    long long size;
+    // Shared with interpreters possibly still parsing a former version
+    std::shared_ptr<const std::string> contents;
+
+    gmicpy_commands_file() : exists(false), mtime(0), size(0) {}
+};
+
+/* Refresh a commands file's cached contents if the file changed since it
+ * was last read. Unchanged files only cost a stat() call. Call this with
+ * the GIL held. */
+static void
+gmicpy_commands_file_refresh(gmicpy_commands_file &file,
+                             const std::string &path)
+{
+    struct stat file_stat;
+    std::FILE *stream = NULL;
+    std::string contents;
+
+    if (stat(path.c_str(), &file_stat) != 0) {
+        file.exists = false;
+        file.contents.reset();
+        return;
+    }
+    if (file.exists && file.mtime == file_stat.st_mtime &&
+        file.size == (long long)file_stat.st_size) {
+        return;
+    }
+    if (!(stream = std::fopen(path.c_str(), "rb"))) {
+        file.exists = false;
+        file.contents.reset();
+        return;
+    }
+    contents.resize(file_stat.st_size);
+    contents.resize(std::fread(&contents[0], 1, contents.size(), stream));
+    std::fclose(stream);
+
+    file.exists = true;
+    file.mtime = file_stat.st_mtime;
+    file.size = (long long)file_stat.st_size;
+    file.contents = std::make_shared<const std::string>(contents);
+}
+
+/** Instancing of any c++ gmic::gmic G'MIC language interpreter object
+ * (Python: gmic.Gmic) **/
+PyObject *
+PyGmic_new(PyTypeObject *subtype, PyObject *args, PyObject *kwargs)
+{
+    PyGmic *self = NULL;
+    // Process-wide caches of the commands files, so that new interpreters
+    // do not read them from disk again. Each interpreter still parses its
+    // commands into tables of its own, which libgmic does not share.
+    static gmicpy_commands_file update_file;
+    static gmicpy_commands_file user_file;
+    static bool is_rc_initialized = false;
+    std::shared_ptr<const std::string> update_commands;
+    std::shared_ptr<const std::string> user_commands;
+    std::string error_message;
+    bool has_load_failed = false;
+
+    self = (PyGmic *)subtype->tp_alloc(subtype, 0);
+    if (self == NULL) {
+        return NULL;
+    }
+
+    // Init resources folder, once per process.
+    if (!is_rc_initialized && !(is_rc_initialized = gmic::init_rc())) {
+        PyErr_Format(GmicException,
+                     "Unable to create G'MIC resources folder.");
+        Py_DECREF(self);
+        return NULL;
+    }
+
+    // Load general and user scripts if they exist
+    // Since this project is a library the G'MIC "update" command that
+    // runs an internet download, is never triggered the user should
+    // run it him/herself.
+    gmicpy_commands_file_refresh(
+        update_file, std::string(gmic::path_rc()) +
+                         "/update" xstr(gmic_version) ".gmic");
+    gmicpy_commands_file_refresh(user_file, gmic::path_user());
+    update_commands = update_file.contents;
+    user_commands = user_file.contents;
+
+    // Like the gmic command-line tool, the update file replaces the
+    // built-in standard library rather than being parsed on top of it
+    Py_BEGIN_ALLOW_THREADS
+    bool has_update = update_commands != NULL;
+    try {
+        if (has_update) {
+            try {
+                self->_gmic->add_commands(update_commands->c_str());
+            }
+            catch (gmic_exception &) {
+                has_update = false;
+            }
+        }
+        if (!has_update) {
+            self->_gmic->add_commands(gmic::decompress_stdlib()._data);
+        }
+        if (user_commands != NULL) {
+            self->_gmic->add_commands(user_commands->c_str());
+        }
+    }
+    catch (gmic_exception &e) {
+        error_message = e.what();
+        has_load_failed = true;
+    }
+    catch (std::exception &e) {
+        error_message = e.what();
+        has_load_failed = true;
+    }
+    Py_END_ALLOW_THREADS
+
+    if (has_load_failed) {
+        PyErr_SetString(GmicException, error_message.c_str());
+        Py_DECREF(self);
+        return NULL;
+    }
+
+    // If parameters are provided, pipe them to our run() method, and
+    // do only exceptions raising without returning anything if things
+    // go well
+    if (args != Py_None && ((args && (int)PyTuple_Size(args) > 0) ||
+                            (kwargs && (int)PyDict_Size(kwargs) > 0))) {
+        PyObject *run_result = run_impl((PyObject *)self, args, kwargs);
+        if (run_result == NULL) {
+            Py_DECREF(self);
+            return NULL;
+        }
+        Py_DECREF(run_result);
+    }
+
+    return (PyObject *)self;
+}
+
+PyDoc_STRVAR(run_impl_doc,
+             "Gmic.run(command, images=None, image_names=None, *, timeout=0, progress=None, profile=False, max_memory=None, outputs=None, move_inputs=False)\n\
+Run G'MIC interpreter following a G'MIC language command(s) string, on 0 or more namable ``GmicImage`` items.\n\n\
+Note (single-image short-hand calling): if ``images`` is a ``GmicImage``, then ``image_names`` must be either a ``str`` or be omitted.\n\n\
+Example:\n\
+    Here is a long example describing several use cases::\n\n\
+        import gmic\n\
+        import struct\n\
+        import random\n\
+        instance1 = gmic.Gmic('echo_stdout \\'instantiation and run all in one\\')\n\
+        instance2 = gmic.Gmic()\n\
+        instance2.run('echo_stdout \\'hello world\\'') # G'MIC command without images parameter\n\
+        a = gmic.GmicImage(struct.pack(*('256f',) + tuple([random.random() for a in range(256)])), 16, 16) # Build 16x16 greyscale image\n\
+        instance2.run('blur 12,0,1 resize 50%,50%', a) # Blur then resize the image\n\
+        a._width == a._height == 8 # The image is half smaller\n\
+        instance2.run('display', a) # If you have X11 enabled (linux only), show the image in a window\n\
+        image_names = ['img_' + str(i) for i in range(10)] # You can also name your images if you have several (optional)\n\
+        images = [gmic.GmicImage(struct.pack(*((str(w*h)+'f',) + (i*2.0,)*w*h)), w, h) for i in range(10)] # Prepare a list of image\n\
+        instance1.run('add 1 print', images, image_names) # And pipe those into the interpreter\n\
+        instance1.run('blur 10,0,1 print', images[0], 'my_pic_name') # Short-hand 1-image calling style\n\n\
+Args:\n\
+    command (str): An image-processing command in the G'MIC language\n\
+    images (Optional[Union[List[gmic.GmicImage], gmic.GmicImage]]): A list of ``GmicImage`` items that G'MIC will edit in place, or a single ``gmic.GmicImage`` which will used for input only. Defaults to None.\n\
+        Put a list variable here, not a plain ``[]``.\n\
+        If you pass a list, it can be empty if you intend to fill or complement it using your G'MIC command.\n\
+        Results are written back by position into the list's ``GmicImage`` objects, so that other references to them (eg. variables or ``numpy.asarray()`` views) see the results, and only images added by G'MIC become new objects. Exported buffers get same-sized results copied into them, and are replaced in the list by new objects otherwise.\n\
+    image_names (Optional[List<str>]): A list of names for the images, defaults to None.\n\
+        In-place editing by G'MIC can happen, you might want to pass your list as a variable instead.\n\
+    timeout (Optional[float]): Seconds after which the run is aborted. Defaults to 0, ie. no limit.\n\
+    progress (Optional[Union[Callable[[float], None], numpy.ndarray]]): Receives the run's progress every 0.1 second and once done, from 0 to 100 or -1 if G'MIC cannot tell. Either a callable (called from another thread, an exception aborts the run and is raised instead), or a writable float32 buffer (eg. ``numpy.zeros(1, numpy.float32)``) whose first item is written without taking the GIL. ``Gmic.progress`` can be polled too. Defaults to None.\n\
+    profile (Optional[bool]): Return a profiling report of the run instead of None. Defaults to False.\n\
+    max_memory (Optional[int]): Memory budget of the run in bytes, or 0 for no limit. The run is charged for the image buffers that G'MIC allocates (less the ones it frees) from the thread running it, and is aborted by the first allocation going over budget. Runs in parallel, eg. in a ``GmicPool`` or ``Gmic.run_batch``, each get their own budget. Allocations of G'MIC's worker threads (OpenMP loops, ``parallel`` command) are not charged. Defaults to None, ie. ``Gmic.max_memory``.\n\
+    outputs (Optional[Union[int, Sequence[int], str]]): Positions of the resulting images to bring back into ``images``, eg. ``-1`` or ``[0, -1]``, or a G'MIC-like selection string such as ``'[0,-1]'`` or ``'0-2'``. Other results (eg. intermediate pyramids or masks) are freed without ever being converted to ``GmicImage``. Selected images keep G'MIC's order, and if the run fails all images come back. Defaults to None, ie. all images.\n\
+    move_inputs (Optional[bool]): Hand the buffers of an images list's ``GmicImage`` items over to G'MIC without copying them, when nothing but the list references them. If the run fails, the list then holds whatever G'MIC left in it rather than being left untouched. Do not touch the list from other threads during the run. Defaults to False, ie. inputs are copied.\n\
+\n\
+Note (threads): the GIL is released while G'MIC works, so several ``gmic.Gmic`` instances can run in parallel from a pool of Python threads. Runs sharing a same instance are serialized.\n\
+\n\
+Returns:\n\
+    Optional[dict]: ``None``, or if ``profile`` is True a dict of measures (times are in seconds, memory in bytes): ``total_seconds``, ``load_seconds`` (parameters checking and images handover to G'MIC), ``lock_wait_seconds`` (waiting for another run of this instance), ``run_seconds`` (G'MIC interpreter), ``store_seconds`` (results handover back to Python), ``input_images``, ``moved_images`` (inputs handed over without copy), ``input_bytes``, ``output_images``, ``output_bytes``, ``untouched_images`` (exported or numpy-shared inputs whose pixels G'MIC left untouched, and which were not copied back), ``openmp_threads``, ``monitor_thread`` (whether a thread watched the run), ``peak_rss_bytes`` and ``peak_rss_growth_bytes`` (the process's peak resident memory after the run, and its growth during the run), ``peak_memory_bytes`` (the run's peak memory, as charged for ``max_memory``).\n\
+\n\
+Raises:\n\
+    GmicException: This translates' G'MIC C++ same-named exception. Look at the exception message for details. Also raised if the run goes over its ``max_memory`` budget. ``images`` and ``image_names`` are left untouched, unless ``move_inputs`` is True.\n\
+    GmicAborted: If the run is stopped by ``Gmic.abort()`` or by its ``timeout``. Parameters are left untouched the same way.\n\
+    BufferError: If a single ``GmicImage`` as ``images``, whose buffer is exported (eg. to a ``memoryview`` or ``numpy.asarray``), would change dimensions. It is left untouched. Same-sized results are copied into its buffer.\n\
+    IndexError: If ``outputs`` selects positions out of the resulting images, which then all come back into ``images``.");
+
+PyDoc_STRVAR(PyGmic_run_async_doc,
+             "Gmic.run_async(command, images=None, image_names=None, *, timeout=0, progress=None)\n\
+Awaitable version of ``Gmic.run``, for use from ``asyncio`` coroutines.\n\n\
+G'MIC runs on a thread of its own, without blocking the event loop nor any executor's worker threads, then results are brought back into ``images`` the same way ``Gmic.run`` does. Do not touch ``images`` until the run is done. Runs on a same ``Gmic`` instance are serialized, use several instances or a ``gmic.GmicPool`` to run them in parallel.\n\n\
+Cancelling the returned future (eg. through ``asyncio.wait_for``) calls ``Gmic.abort()``, which also aborts this instance's other runs in progress or waiting. ``images`` are then left untouched.\n\n\
+Example:\n\
+    Filtering from a coroutine::\n\n\
+        import asyncio\n\
+        import gmic\n\
+        async def main():\n\
+            g = gmic.Gmic()\n\
+            images = []\n\
+            await g.run_async('sp apples blur 2', images)\n\
+        asyncio.run(main())\n\n\
+Args:\n\
+    command (str): An image-processing command in the G'MIC language\n\
+    images (Optional[Union[List[gmic.GmicImage], gmic.GmicImage]]): See ``Gmic.run``.\n\
+    image_names (Optional[List<str>]): See ``Gmic.run``.\n\
+    timeout (Optional[float]): See ``Gmic.run``.\n\
+    progress (Optional[Union[Callable[[float], None], numpy.ndarray]]): See ``Gmic.run``.\n\
+\n\
+Returns:\n\
+    asyncio.Future: A future whose result is the ``images`` parameter once G'MIC is done with it (or ``None``), or which raises the run's ``GmicException``.\n\
+\n\
+Raises:\n\
+    RuntimeError: If called outside of a running event loop.");
+
+PyDoc_STRVAR(PyGmic_run_batch_doc,
+             "Gmic.run_batch(command, images_sets, threads=0, *, timeout=0)\n\
+Run a same G'MIC command on many independent sets of images, spread over several native threads.\n\n\
+All sets are checked and prepared once, then worker threads run the command on them without the GIL, each with its own warm interpreter. The first worker uses this instance, the others use extra ``gmic.Gmic`` instances created on first use and kept for later batches.\n\n\
+Example:\n\
+    Filtering frames on all CPU cores::\n\n\
+        import gmic\n\
+        g = gmic.Gmic()\n\
+        frames = [[gmic.GmicImage.from_numpy(f)] for f in my_numpy_frames]\n\
+        for images in g.run_batch('blur 2 sharpen 50 resize 50%,50%', frames):\n\
+            print(images)\n\n\
+Args:\n\
+    command (str): An image-processing command in the G'MIC language\n\
+    images_sets (List[Union[List[gmic.GmicImage], gmic.GmicImage]]): ``images`` parameters, one per run. They are edited in place as with ``Gmic.run``.\n\
+    threads (Optional[int]): Maximum number of worker threads. Defaults to 0, ie. the number of CPU cores.\n\
+    timeout (Optional[float]): Seconds after which each set's run is aborted. Defaults to 0, ie. no limit.\n\
+\n\
+Note (memory): each set's run gets the ``Gmic.max_memory`` budget, whether sets run in parallel or not.\n\
+\n\
+Returns:\n\
+    list: The ``images_sets`` items, in input order, once G'MIC is done with all of them.\n\
+\n\
+Raises:\n\
+    GmicException: For the first failing set, once results of all sets have been brought back. It is a ``GmicAborted`` if the set was aborted or timed out.\n\
+    ValueError: If ``threads`` is negative.");
+
+/* Grow the list of extra warm interpreters used by Gmic.run_batch() up to
+ * 'count' items. */
+static bool
+PyGmic_ensure_batch_interpreters(PyGmic *self, Py_ssize_t count)
+{
+    PyObject *interpreter = NULL;
+
+    if (self->_batch_interpreters == NULL &&
+        !(self->_batch_interpreters = PyList_New(0))) {
+        return false;
+    }
+
+    while (PyList_GET_SIZE(self->_batch_interpreters) < count) {
+        interpreter = PyGmic_new(&PyGmicType, NULL, NULL);
+        if (interpreter == NULL) {
+            return false;
+        }
+        if (PyList_Append(self->_batch_interpreters, interpreter) < 0) {
+            Py_DECREF(interpreter);
+            return false;
+        }
+        Py_DECREF(interpreter);
+    }
+
+    return true;
+}
+
+static PyObject *
+PyGmic_run_batch(PyGmic *self, PyObject *args, PyObject *kwargs)
+{
+    char const *keywords[] = {"command", "images_sets", "threads", "timeout",
+                              NULL};
+    char *commands_line = NULL;
+    PyObject *input_images_sets = NULL;
+    PyObject *images_sets = NULL;
+    PyObject *result = NULL;
+    PyObject *error_type = NULL;
+    PyObject *error_value = NULL;
+    PyObject *error_traceback = NULL;
+    Py_ssize_t threads = 0;  // Defaults to the number of CPU cores
+    Py_ssize_t sets_count = 0;
+    Py_ssize_t workers_count = 0;
+    Py_ssize_t set_position = 0;
+    gmicpy_run_options options;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sO|n$d", (char **)keywords,
+                                     &commands_line, &input_images_sets,
+                                     &threads, &options.timeout)) {
+        return NULL;
+    }
+
+    if (threads < 0) {
+        PyErr_Format(PyExc_ValueError,
+                     "'threads' parameter must be positive or 0 (for the "
+                     "number of CPU cores), got %zd.",
+                     threads);
+        return NULL;
+    }
+    if (threads == 0) {
+        threads = (Py_ssize_t)std::thread::hardware_concurrency();
+        threads = threads > 0 ? threads : 1;
+    }
+    options.max_memory = self->_max_memory;
+
+    images_sets = PySequence_Fast(
+        input_images_sets,
+        "'images_sets' parameter must be a list of 'images' parameters.");
+    if (images_sets == NULL) {
+        return NULL;
+    }
+    sets_count = PySequence_Fast_GET_SIZE(images_sets);
+    workers_count = threads < sets_count ? threads : sets_count;
+
+    if (!PyGmic_ensure_batch_interpreters(self, workers_count - 1)) {
+        Py_DECREF(images_sets);
+        return NULL;
+    }
+
+    try {
+        std::vector<gmicpy_run_io> ios(sets_count);
+        std::vector<gmicpy_run_report> reports(sets_count);
+        std::vector<gmicpy_run_status> statuses(sets_count, GMICPY_RUN_DONE);
+        std::vector<PyGmic *> interpreters;
+        std::atomic<Py_ssize_t> next_set_position(0);
+        std::atomic<bool> is_batch_aborted(false);
+
+        // Check and marshal all sets once, before any worker starts
+        for (set_position = 0; set_position < sets_count; set_position++) {
+            if (!gmicpy_run_io_load(
+                    &ios[set_position],
+                    PySequence_Fast_GET_ITEM(images_sets, set_position),
+                    Py_None, false)) {
+                break;
+            }
+        }
+        if (set_position < sets_count) {
+            // Inputs were copied, so sets are left untouched
+            for (Py_ssize_t l = 0; l < sets_count; l++) {
+                gmicpy_run_io_clear(&ios[l]);
+            }
+            Py_DECREF(images_sets);
+            return NULL;
+        }
+
+        // Interpreters are owned by self, which outlives this call
+        interpreters.push_back(self);
+        for (Py_ssize_t l = 0; l < workers_count - 1; l++) {
+            interpreters.push_back(
+                (PyGmic *)PyList_GET_ITEM(self->_batch_interpreters, l));
+        }
+
+        Py_BEGIN_ALLOW_THREADS
+        std::vector<std::thread> workers;
+        // Each worker pulls the next pending set until none is left, so
+        // that sets of uneven costs still keep all cores busy. Once
+        // Gmic.abort() stops a set, pending sets are given up too.
+        auto work = [&](PyGmic *interpreter) {
+            Py_ssize_t position;
+            while ((position = next_set_position++) < sets_count) {
+                if (is_batch_aborted) {
+                    statuses[position] = GMICPY_RUN_ABORTED;
+                    reports[position].error_message = "G'MIC run was aborted.";
+                    continue;
+                }
+                statuses[position] = PyGmic_run_nogil_locked(
+                    interpreter, commands_line, ios[position].images,
+                    ios[position].image_names, options, reports[position]);
+                if (statuses[position] == GMICPY_RUN_ABORTED) {
+                    is_batch_aborted = true;
+                }
+            }
+        };
+        try {
+            for (size_t l = 1; l < interpreters.size(); l++) {
+                workers.push_back(std::thread(work, interpreters[l]));
+            }
+        }
+        catch (std::exception &) {
+            // Go on with the workers started so far
+        }
+        work(interpreters[0]);
+        for (size_t l = 0; l < workers.size(); l++) {
+            workers[l].join();
+        }
+        Py_END_ALLOW_THREADS
+
+        // Bring results back into each set, in order, keeping the first
+        // error only
+        result = PyList_New(sets_count);
+        for (set_position = 0; set_position < sets_count; set_position++) {
+            if (statuses[set_position] != GMICPY_RUN_DONE) {
+                PyErr_Format(gmicpy_run_error_type(statuses[set_position]),
+                             "Images set %zd: %s", set_position,
+                             reports[set_position].error_message.c_str());
+            }
+            if (!gmicpy_run_io_store(
+                    &ios[set_position],
+                    statuses[set_position] != GMICPY_RUN_DONE)) {
+                if (error_type == NULL) {
+                    PyErr_Fetch(&error_type, &error_value, &error_traceback);
+                }
+                else {
+                    PyErr_Clear();
+                }
+            }
+            gmicpy_run_io_clear(&ios[set_position]);
+            if (result != NULL) {
+                PyObject *images_set =
+                    PySequence_Fast_GET_ITEM(images_sets, set_position);
+                Py_INCREF(images_set);
+                PyList_SET_ITEM(result, set_position, images_set);
+            }
+        }
+    }
+    catch (std::exception &e) {
+        Py_XDECREF(error_type);
+        Py_XDECREF(error_value);
+        Py_XDECREF(error_traceback);
+        Py_XDECREF(result);
+        Py_DECREF(images_sets);
+        PyErr_SetString(GmicException, e.what());
+        return NULL;
+    }
+    Py_DECREF(images_sets);
+
+    if (error_type != NULL) {
+        Py_XDECREF(result);
+        PyErr_Restore(error_type, error_value, error_traceback);
+        return NULL;
+    }
+
+    return result;
+}
+
+PyDoc_STRVAR(PyGmic_abort_doc,
+             "Gmic.abort()\n\
+Stop the ongoing run of this interpreter as soon as possible, from another thread. A ``Gmic.run_batch`` call gives up its pending sets too.\n\n\
+Runs already waiting for the interpreter are stopped too, runs started afterwards are not affected. Does nothing if no run is ongoing.\n\n\
+Example:\n\
+    Stopping a run from a timer thread::\n\n\
+        import threading\n\
+        import gmic\n\
+        g = gmic.Gmic()\n\
+        threading.Timer(1, g.abort).start()\n\
+        try:\n\
+            g.run('sp apples repeat 1000000 blur 1 done')\n\
+        except gmic.GmicAborted:\n\
+            print('stopped')\n\n\
+Returns:\n\
+    None: The aborted run raises ``gmic.GmicAborted`` in its own thread.");
+
+/* Abort the ongoing run of an interpreter and the runs waiting for it. */
+static void
+gmicpy_abort_runs(PyGmic *interpreter)
+{
+    unsigned long entered_runs = interpreter->_entered_runs;
+    unsigned long aborted_runs = interpreter->_aborted_runs;
+
+    while (aborted_runs < entered_runs &&
+           !interpreter->_aborted_runs.compare_exchange_weak(aborted_runs,
+                                                            entered_runs)) {
+    }
+    // G'MIC polls this flag between and within commands
+    interpreter->_is_abort = true;
+}
+
+static PyObject *
+PyGmic_abort(PyGmic *self, PyObject *args)
+{
+    gmicpy_abort_runs(self);
+    if (self->_batch_interpreters != NULL) {
+        for (Py_ssize_t l = 0; l < PyList_GET_SIZE(self->_batch_interpreters);
+             l++) {
+            gmicpy_abort_runs(
+                (PyGmic *)PyList_GET_ITEM(self->_batch_interpreters, l));
+        }
+    }
+
+    Py_RETURN_NONE;
+}
+
+static PyObject *
+PyGmic_get_progress(PyGmic *self, void *closure)
+{
+    // Read without the instance lock, so that it can be polled from
+    // another thread while a run is ongoing
+    return PyFloat_FromDouble((double)self->_progress);
+}
+
+static PyObject *
+PyGmic_get__entered_runs(PyGmic *self, void *closure)
+{
+    return PyLong_FromUnsignedLong(self->_entered_runs);
+}
+
+static PyObject *
+PyGmic_get_max_memory(PyGmic *self, void *closure)
+{
+    return PyLong_FromSize_t(self->_max_memory);
+}
+
+static int
+PyGmic_set_max_memory(PyGmic *self, PyObject *value, void *closure)
+{
+    if (value == NULL) {
+        PyErr_SetString(PyExc_TypeError, "Cannot delete 'max_memory'.");
+        return -1;
+    }
+    if (!gmicpy_parse_max_memory(value, 0, &self->_max_memory)) {
+        return -1;
+    }
+
+    return 0;
+}
+
+PyGetSetDef PyGmic_getsets[] = {
+    {(char *)"progress", (getter)PyGmic_get_progress, NULL,
+     "Progress of the ongoing or last run, from 0 to 100, or -1 if G'MIC "
+     "cannot tell",
+     NULL},
+    {(char *)"max_memory", (getter)PyGmic_get_max_memory,
+     (setter)PyGmic_set_max_memory,
+     "Default memory budget of this interpreter's runs in bytes, or 0 for "
+     "no limit. See Gmic.run()'s 'max_memory' parameter.",
+     NULL},
+    {(char *)"_entered_runs", (getter)PyGmic_get__entered_runs, NULL,
+     "Number of runs entered so far, including those waiting for the "
+     "interpreter",
+     NULL},
+    {NULL}};
+
+PyDoc_STRVAR(PyGmic_stream_doc,
+             "Gmic.stream(command, frames, reuse_output=False)\n\
+Run a same G'MIC command on each frame of an iterable (eg. video frames), yielding results as they come.\n\n\
+While G'MIC processes a frame on a worker thread without the GIL, the next frame is pulled and converted. Input buffers are reused from frame to frame, and with ``reuse_output`` the yielded images too, so that a steady stream of same-sized frames allocates almost nothing.\n\n\
+Example:\n\
+    Filtering camera frames::\n\n\
+        import gmic\n\
+        g = gmic.Gmic()\n\
+        for images in g.stream('blur 2 sharpen 50', camera_numpy_frames, reuse_output=True):\n\
+            show(images[0].to_numpy())\n\n\
+Args:\n\
+    command (str): An image-processing command in the G'MIC language\n\
+    frames (Iterable): Frames, each being a ``gmic.GmicImage`` (left untouched), or a (height, width) or (height, width, channels) C-contiguous float32 or uint8 buffer such as a ``numpy.ndarray``. Other objects, eg. ``PIL.Image.Image`` frames, are converted with ``numpy.asarray``.\n\
+    reuse_output (Optional[bool]): Yield the same list and ``GmicImage`` objects each time, their buffers being swapped with the new results. Use or copy each result before asking for the next one. Defaults to False.\n\
+\n\
+Returns:\n\
+    gmic.GmicStream: An iterator yielding a list of ``gmic.GmicImage`` per frame.\n\
+\n\
+Raises:\n\
+    GmicException: When iterating, if G'MIC fails on a frame. The stream then stops.");
+
+// Defined with the G'MIC frames stream binding below
+static PyObject *
+PyGmic_stream(PyGmic *self, PyObject *args, PyObject *kwargs);
+
+PyDoc_STRVAR(PyGmic_session_doc,
+             "Gmic.session(images=None, image_names=None)\n\
+Open a session whose images stay resident in G'MIC's own memory across runs, so that chained commands avoid converting images to and from Python between steps. Images only cross the Python boundary through ``push()``, ``fetch()`` and ``pop()``.\n\n\
+Example:\n\
+    Chaining commands on resident images::\n\n\
+        import gmic\n\
+        g = gmic.Gmic()\n\
+        s = g.session(gmic.GmicImage(struct.pack('4f', 1, 2, 3, 4), 2, 2))\n\
+        s.run('blur 1')\n\
+        s.run('normalize 0,255')\n\
+        result = s.fetch()\n\n\
+Args:\n\
+    images (Optional[Union[List[gmic.GmicImage], gmic.GmicImage]]): Initial images, copied into the session. Defaults to None.\n\
+    image_names (Optional[List[str]]): Names of the initial images. Defaults to None.\n\
+\n\
+Returns:\n\
+    gmic.GmicSession: A session running its commands on this interpreter.\n\
+\n\
+Raises:\n\
+    TypeError: If ``images`` or ``image_names`` have wrong types.");
+
+// Defined with the G'MIC images session binding below
+static PyObject *
+PyGmic_session(PyGmic *self, PyObject *args, PyObject *kwargs);
+
+static PyMethodDef PyGmic_methods[] = {
+    {"run", (PyCFunction)run_impl, METH_VARARGS | METH_KEYWORDS, run_impl_doc},
+    {"run_async", (PyCFunction)PyGmic_run_async, METH_VARARGS | METH_KEYWORDS,
+     PyGmic_run_async_doc},
+    {"run_batch", (PyCFunction)PyGmic_run_batch, METH_VARARGS | METH_KEYWORDS,
+     PyGmic_run_batch_doc},
+    {"abort", (PyCFunction)PyGmic_abort, METH_NOARGS, PyGmic_abort_doc},
+    {"stream", (PyCFunction)PyGmic_stream, METH_VARARGS | METH_KEYWORDS,
+     PyGmic_stream_doc},
+    {"session", (PyCFunction)PyGmic_session, METH_VARARGS | METH_KEYWORDS,
+     PyGmic_session_doc},
+    {"_run", (PyCFunction)run_impl_returning_images,
+     METH_VARARGS | METH_KEYWORDS,
+     "Gmic.run() returning its 'images' parameter, for worker threads."},
+    {NULL} /* Sentinel */
+};
+
+// ------------ G'MIC IMAGE BINDING ----//
+
+PyObject *
+PyGmicImage_new(PyTypeObject *subtype, PyObject *args, PyObject *kwargs)
+{
+    PyGmicImage *self = NULL;
+    unsigned int _width =
+        1;  // Number of image columns (dimension along the X-axis)
+    unsigned int _height =
+        1;  // Number of image lines (dimension along the Y-axis)
+    unsigned int _depth =
+        1;  // Number of image slices (dimension along the Z-axis)
+    unsigned int _spectrum =
+        1;  // Number of image channels (dimension along the C-axis)
+    Py_ssize_t dimensions_product;  // All integer parameters
+                                    // multiplied together,
+    // will help for allocating (ie. assign()ing)
+    Py_ssize_t _data_bytes_size;
+    int _is_shared = 0;  // Whether image should be shared across gmic
+                         // operations (if true,
+    // operations like resize will fail)
+    PyObject *bytesObj = NULL;  // Incoming bytes buffer object pointer
+
+    bool bytesObj_is_bytes = false;
+    char const *keywords[] = {"data",     "width",  "height", "depth",
+                              "spectrum", "shared", NULL};
+
+    // Parameters parsing and checking
+    if (!PyArg_ParseTupleAndKeywords(
+            args, kwargs, "|OIIIIp", (char **)keywords, &bytesObj, &_width,
+            &_height, &_depth, &_spectrum, &_is_shared))
+        return NULL;
+
+    self = (PyGmicImage *)subtype->tp_alloc(subtype, 0);
+    if (self == NULL) {
+        return NULL;
+    }
+
+    // Default bytesObj value to None
+    if (bytesObj == NULL) {
+        bytesObj = Py_None;
+    }
+    else {
+        Py_INCREF(bytesObj);
+    }
+
+    if (bytesObj != Py_None) {
+        bytesObj_is_bytes = (bool)PyBytes_Check(bytesObj);
+        if (!bytesObj_is_bytes) {
+            PyErr_Format(PyExc_TypeError,
+                         "Parameter 'data' must be a "
+                         "pure-python 'bytes' buffer object.");
+            // TODO pytest this
+            return NULL;
+        }
+    }
+    else {  // if bytesObj is None, attempt to set it as an empty bytes
+            // object
+        // following image dimensions
+        // If dimensions are OK, create a pixels-count-zero-filled
+        // bytesarray-based bytes object to be ingested by the _data
+        // parameter
+        if (_width >= 1 && _height >= 1 && _depth >= 1 && _spectrum >= 1) {
+            bytesObj = PyObject_CallFunction(
+                (PyObject *)&PyBytes_Type, "O",
+                PyObject_CallFunction(
+                    (PyObject *)&PyByteArray_Type, "I",
+                    _width * _height * _depth * _spectrum * sizeof(T), NULL),
+                NULL);
+            Py_INCREF(bytesObj);
+            bytesObj_is_bytes = true;
+            // TODO pytest this
+        }
+        else {  // If dimensions are not OK, raise exception
+            PyErr_Format(PyExc_TypeError,
+                         "If you do not provide a 'data' parameter, make at "
+                         "least all dimensions >=1.");
+            // TODO pytest this
+            return NULL;
+        }
+    }
+
+    // Bytes object spatial dimensions vs. bytes-length checking
+    dimensions_product = _width * _height * _depth * _spectrum;
+    _data_bytes_size = PyBytes_Size(bytesObj);
+    if ((Py_ssize_t)(dimensions_product * sizeof(T)) != _data_bytes_size) {
+        PyErr_Format(PyExc_ValueError,
+                     "GmicImage dimensions-induced buffer bytes size "
+                     "(%d*%dB=%d) cannot be strictly negative or "
+                     "different than the _data buffer size in bytes (%d)",
+                     dimensions_product, sizeof(T),
+                     dimensions_product * sizeof(T), _data_bytes_size);
+        return NULL;
+    }
+
+    // Importing input data to an internal buffer
+    try {
+        self->_gmic_image->assign(_width, _height, _depth, _spectrum);
+        self->_gmic_image->_is_shared = _is_shared;
+    }
+    // Ugly exception catching, probably to catch a
+    // cimg::GmicInstanceException()
+    catch (...) {
+        dimensions_product = _width * _height * _depth * _spectrum;
+        PyErr_Format(PyExc_MemoryError,
+                     "Allocation error in "
+                     "GmicImage::assign(_width=%d,_height=%d,_depth=%d,_"
+                     "spectrum=%d), "
+                     "are you requesting too much memory (%d bytes)?",
+                     _width, _height, _depth, _spectrum,
+                     dimensions_product * sizeof(T));
+        return NULL;
+    }
+
+    memcpy(self->_gmic_image->_data, PyBytes_AsString(bytesObj),
+           PyBytes_Size(bytesObj));
+
+    Py_XDECREF(bytesObj);
+
+    return (PyObject *)self;
+}
+
+static PyObject *
+PyGmicImage_repr(PyGmicImage *self)
+{
+    return PyUnicode_FromFormat(
+        "<%s object at %p with _data address at %p, w=%d h=%d d=%d "
+        "s=%d "
+        "shared=%d>",
+        Py_TYPE(self)->tp_name, self, self->_gmic_image->_data,
+        self->_gmic_image->_width, self->_gmic_image->_height,
+        self->_gmic_image->_depth, self->_gmic_image->_spectrum,
+        self->_gmic_image->_is_shared);
+}
+
+static PyObject *
+PyGmicImage_call(PyObject *self, PyObject *args, PyObject *kwargs)
+{
+    const char *keywords[] = {"x", "y", "z", "s", NULL};
+    int x, y, z, c;
+    x = y = z = c = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|iiii", (char **)keywords,
+                                     &x, &y, &z, &c)) {
+        return NULL;
+    }
+
+    return PyFloat_FromDouble(
+        (*((PyGmicImage *)self)->_gmic_image)(x, y, z, c));
+}
+
+enum gmicpy_interpolation {
+    GMICPY_INTERPOLATION_NEAREST,
+    GMICPY_INTERPOLATION_LINEAR,
+    GMICPY_INTERPOLATION_CUBIC
+};
+
+/* Parse an 'interpolation' parameter among the names of a given number of
+ * gmicpy_interpolation values. Returns false with a GmicException set
+ * otherwise. */
+static bool
+gmicpy_parse_interpolation(const char *name, int names_count,
+                           gmicpy_interpolation &interpolation)
+{
+    const char *names[] = {"nearest", "linear", "cubic"};
+
+    for (int i = 0; i < names_count; i++) {
+        if (strcmp(name, names[i]) == 0) {
+            interpolation = (gmicpy_interpolation)i;
+            return true;
+        }
+    }
+    PyErr_Format(GmicException,
+                 "'interpolation' parameter should be one of 'nearest', "
+                 "'linear'%s, '%s' found.",
+                 names_count > 2 ? " or 'cubic'" : "", name);
+    return false;
+}
+
+/* Read a (count, axes) matrix of numbers into the lines of an image of
+ * 'axes' width and 'count' height, from a number, a C-contiguous 0-2D
+ * buffer (eg. a numpy array) or a sequence of numbers or of equally-sized
+ * sequences of numbers. Returns false with a Python exception set
+ * otherwise. */
+static bool
+gmicpy_read_points(PyObject *object, const char *name, gmic_image<T> &points)
+{
+    Py_buffer buffer;
+    PyObject *sequence = NULL;
+    PyObject *item_sequence = NULL;
+    Py_ssize_t count = 0, axes = 0;
+
+    if (PyObject_CheckBuffer(object) &&
+        PyObject_GetBuffer(object, &buffer,
+                           PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) == 0) {
+        if (buffer.ndim <= 2 && strlen(buffer.format) == 1 &&
+            strchr("?bBhHiIlLqQfd", buffer.format[0]) != NULL) {
+            count = buffer.ndim > 0 ? buffer.shape[0] : 1;
+            axes = buffer.ndim > 1 ? buffer.shape[1] : 1;
+            points.assign();
+            if (count > 0 && axes > 0) {
+                points.assign((unsigned int)axes, (unsigned int)count);
+                gmicpy_import_pixels_from(buffer.buf, buffer.format[0],
+                                          points, false);
+            }
+            PyBuffer_Release(&buffer);
+            return true;
+        }
+        // Other item types are read as sequences
+        PyBuffer_Release(&buffer);
+    }
+    PyErr_Clear();
+
+    if (PyNumber_Check(object) && !PySequence_Check(object)) {
+        points.assign(1, 1, 1, 1, (T)PyFloat_AsDouble(object));
+        return !PyErr_Occurred();
+    }
+
+    sequence = PySequence_Fast(object, "");
+    if (sequence == NULL) {
+        PyErr_Format(PyExc_TypeError,
+                     "'%s' parameter must be a number, a 1D or 2D buffer or "
+                     "a sequence of numbers or of sequences of numbers, "
+                     "'%.50s' found.",
+                     name, Py_TYPE(object)->tp_name);
+        return false;
+    }
+    count = PySequence_Fast_GET_SIZE(sequence);
+    points.assign();
+    for (Py_ssize_t p = 0; p < count; p++) {
+        PyObject *item = PySequence_Fast_GET_ITEM(sequence, p);
+        Py_ssize_t item_axes = 1;
+
+        item_sequence = PySequence_Check(item)
+                            ? PySequence_Fast(item, "")
+                            : NULL;
+        if (item_sequence != NULL) {
+            item_axes = PySequence_Fast_GET_SIZE(item_sequence);
+        }
+        if (p == 0 && item_axes > 0) {
+            axes = item_axes;
+            points.assign((unsigned int)axes, (unsigned int)count);
+        }
+        if (item_axes != axes) {
+            PyErr_Format(PyExc_TypeError,
+                         "Items of the '%s' parameter must all have %d "
+                         "numbers, %d found at position %d.",
+                         name, (int)axes, (int)item_axes, (int)p);
+            Py_XDECREF(item_sequence);
+            Py_DECREF(sequence);
+            return false;
+        }
+        for (Py_ssize_t a = 0; a < axes; a++) {
+            points((unsigned int)a, (unsigned int)p) = (T)PyFloat_AsDouble(
+                item_sequence != NULL
+                    ? PySequence_Fast_GET_ITEM(item_sequence, a)
+                    : item);
+        }
+        Py_XDECREF(item_sequence);
+        if (PyErr_Occurred()) {
+            Py_DECREF(sequence);
+            return false;
+        }
+    }
+    Py_DECREF(sequence);
+
+    return true;
+}
+
+/* Value of an image at floating coordinates, either clamped to the image
+ * bounds (Neumann boundary) or out_value out of them (Dirichlet boundary)
+ * if not NULL. Cubic interpolation happens along x, y and z only. */
+static inline T
+gmicpy_sample_pixel(const gmic_image<T> &image, float fx, float fy, float fz,
+                    float fc, gmicpy_interpolation interpolation,
+                    const T *out_value)
+{
+    int c = 0;
+
+    switch (interpolation) {
+        case GMICPY_INTERPOLATION_LINEAR:
+            return (T)(out_value != NULL
+                           ? image.linear_atXYZC(fx, fy, fz, fc, *out_value)
+                           : image._linear_atXYZC(fx, fy, fz, fc));
+        case GMICPY_INTERPOLATION_CUBIC:
+            c = gmicpy_pixel_cast<int>::cast(fc);
+            if (out_value != NULL) {
+                return c < 0 || c >= image.spectrum()
+                           ? *out_value
+                           : (T)image.cubic_atXYZ(fx, fy, fz, c, *out_value);
+            }
+            c = std::max(0, std::min(c, image.spectrum() - 1));
+            return (T)image._cubic_atXYZ(fx, fy, fz, c);
+        default:
+            if (out_value != NULL) {
+                return image.atXYZC(gmicpy_pixel_cast<int>::cast(fx),
+                                    gmicpy_pixel_cast<int>::cast(fy),
+                                    gmicpy_pixel_cast<int>::cast(fz),
+                                    gmicpy_pixel_cast<int>::cast(fc),
+                                    *out_value);
+            }
+            return image._atXYZC(gmicpy_pixel_cast<int>::cast(fx),
+                                 gmicpy_pixel_cast<int>::cast(fy),
+                                 gmicpy_pixel_cast<int>::cast(fz),
+                                 gmicpy_pixel_cast<int>::cast(fc));
+    }
+}
+
+PyDoc_STRVAR(
+    PyGmicImage_gather_doc,
+    "GmicImage.gather(coords, interpolation='nearest', out_value=None)\n\n\
+Read the pixel values at many coordinates at once, which is much faster than calling ``image(x, y, z, s)`` for each of them.\n\
+Each point is a line of 1 to 4 ``(x[, y[, z[, s]]])`` coordinates, missing ones being 0, except for the channel one: points without it get the values of all channels.\n\n\
+Args:\n\
+    coords: A (points, axes) C-contiguous buffer of numbers (eg. a ``numpy.ndarray`` of integers or floats), or a sequence of numbers or of coordinate sequences.\n\
+    interpolation (str): One of 'nearest' (coordinates are rounded), 'linear' or 'cubic' (along x, y and z).\n\
+    out_value (Optional[float]): Value of points out of the image. If ``None``, coordinates are clamped to the image bounds instead.\n\
+\n\
+Returns:\n\
+    memoryview: A float32 memoryview of (points,) shape if coordinates have 4 axes, or (points, spectrum) shape otherwise. ``numpy.asarray()`` can wrap it without copy.\n\
+\n\
+Raises:\n\
+    GmicException: If coordinates have more than 4 axes, the interpolation is unknown or the image is empty.");
+
+static PyObject *
+PyGmicImage_gather(PyGmicImage *self, PyObject *args, PyObject *kwargs)
+{
+    char const *keywords[] = {"coords", "interpolation", "out_value", NULL};
+    PyObject *arg_coords = NULL;
+    char *arg_interpolation = (char *)"nearest";
+    PyObject *arg_out_value = Py_None;
+    gmicpy_interpolation interpolation = GMICPY_INTERPOLATION_NEAREST;
+    T out_value = 0;
+    const T *out_value_pointer = NULL;
+    gmic_image<T> points;
+    const gmic_image<T> &image = *self->_gmic_image;
+    PyObject *values_bytes = NULL;
+    PyObject *values_view = NULL;
+    PyObject *return_view = NULL;
+    float *values = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|sO", (char **)keywords,
+                                     &arg_coords, &arg_interpolation,
+                                     &arg_out_value)) {
+        return NULL;
+    }
+    if (!gmicpy_parse_interpolation(arg_interpolation, 3, interpolation)) {
+        return NULL;
+    }
+    if (arg_out_value != Py_None) {
+        out_value = (T)PyFloat_AsDouble(arg_out_value);
+        if (PyErr_Occurred()) {
+            return NULL;
+        }
+        out_value_pointer = &out_value;
+    }
+    if (!gmicpy_read_points(arg_coords, "coords", points)) {
+        return NULL;
+    }
+
+    const unsigned int axes = points._width, count = points._height;
+    const unsigned int channels = axes == 4 ? 1 : image._spectrum;
+    if (axes > 4) {
+        PyErr_Format(GmicException,
+                     "'coords' points should have 1 to 4 (x, y, z, s) "
+                     "coordinates, %d found.",
+                     axes);
+        return NULL;
+    }
+    if (count > 0 && image.is_empty()) {
+        PyErr_SetString(GmicException,
+                        "Cannot gather pixel values from an empty GmicImage.");
+        return NULL;
+    }
+
+    values_bytes = PyByteArray_FromStringAndSize(
+        NULL, (Py_ssize_t)count * channels * sizeof(float));
+    if (values_bytes == NULL) {
+        return NULL;
+    }
+    values = (float *)PyByteArray_AS_STRING(values_bytes);
+    const int threads = gmicpy_conversion_threads((size_t)count * channels);
+
+#if cimg_use_openmp != 0
+#pragma omp parallel for num_threads(threads) if (threads > 1)
+#endif
+    for (long p = 0; p < (long)count; p++) {
+        const T *point = points.data(0, (unsigned int)p);
+        const float fx = point[0], fy = axes > 1 ? point[1] : 0,
+                    fz = axes > 2 ? point[2] : 0;
+        for (unsigned int c = 0; c < channels; c++) {
+            values[p * channels + c] = (float)gmicpy_sample_pixel(
+                image, fx, fy, fz, axes == 4 ? point[3] : (float)c,
+                interpolation, out_value_pointer);
+        }
+    }
+
+    values_view = PyMemoryView_FromObject(values_bytes);
+    Py_DECREF(values_bytes);
+    if (values_view == NULL) {
+        return NULL;
+    }
+    // Zero-sized shapes cannot be cast into
+    if (count == 0) {
+        return_view = PyObject_CallMethod(values_view, "cast", "s", "f");
+    }
+    else if (axes == 4) {
+        return_view = PyObject_CallMethod(values_view, "cast", "s(I)", "f",
+                                          count);
+    }
+    else {
+        return_view = PyObject_CallMethod(values_view, "cast", "s(II)", "f",
+                                          count, channels);
+    }
+    Py_DECREF(values_view);
+
+    return return_view;
+}
 
-    for (j = 0; j < nb_subplots; j++) {
-        if (use_matplotlib) {
-            image = PyObject_CallMethod(
-                matplotlib_image_module, "imread", "O",
-                PyList_GetItem(all_image_expanded_filenames, j));
-            if (!image) {
-                return image;
+PyDoc_STRVAR(
+    PyGmicImage_scatter_doc,
+    "GmicImage.scatter(coords, values, interpolation='nearest')\n\n\
+Write pixel values at many coordinates at once, which is much faster than going through a G'MIC command or numpy for sparse points.\n\
+Points are given the same way as with ``GmicImage.gather()``, and points out of the image are skipped.\n\n\
+Args:\n\
+    coords: A (points, axes) C-contiguous buffer of numbers (eg. a ``numpy.ndarray``), or a sequence of numbers or of coordinate sequences.\n\
+    values: A single value for all points, one value per point, or for points without a channel coordinate, one value per point and channel, given as a number, a buffer or a sequence.\n\
+    interpolation (str): One of 'nearest' (coordinates are rounded) or 'linear' (values are spread over the neighbouring pixels, along x, y and z).\n\
+\n\
+Raises:\n\
+    GmicException: If coordinates have more than 4 axes, values do not match points or the interpolation is unknown.");
+
+static PyObject *
+PyGmicImage_scatter(PyGmicImage *self, PyObject *args, PyObject *kwargs)
+{
+    char const *keywords[] = {"coords", "values", "interpolation", NULL};
+    PyObject *arg_coords = NULL;
+    PyObject *arg_values = NULL;
+    char *arg_interpolation = (char *)"nearest";
+    gmicpy_interpolation interpolation = GMICPY_INTERPOLATION_NEAREST;
+    gmic_image<T> points;
+    gmic_image<T> values;
+    gmic_image<T> &image = *self->_gmic_image;
+    size_t values_step = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "OO|s", (char **)keywords,
+                                     &arg_coords, &arg_values,
+                                     &arg_interpolation)) {
+        return NULL;
+    }
+    if (!gmicpy_parse_interpolation(arg_interpolation, 2, interpolation) ||
+        !gmicpy_read_points(arg_coords, "coords", points) ||
+        !gmicpy_read_points(arg_values, "values", values)) {
+        return NULL;
+    }
+
+    const unsigned int axes = points._width, count = points._height;
+    const unsigned int channels = axes == 4 ? 1 : image._spectrum;
+    if (axes > 4) {
+        PyErr_Format(GmicException,
+                     "'coords' points should have 1 to 4 (x, y, z, s) "
+                     "coordinates, %d found.",
+                     axes);
+        return NULL;
+    }
+    // Values are broadcast over points and channels when fewer
+    if (values.size() == (size_t)count * channels) {
+        values_step = channels;
+    }
+    else if (values.size() == count) {
+        values_step = 1;
+    }
+    else if (values.size() != 1) {
+        PyErr_Format(GmicException,
+                     "'values' parameter should have 1, %d or %d numbers for "
+                     "%d points, %d found.",
+                     count, count * channels, count, (int)values.size());
+        return NULL;
+    }
+
+    for (unsigned int p = 0; p < count; p++) {
+        const T *point = points.data(0, p);
+        const float fx = point[0], fy = axes > 1 ? point[1] : 0,
+                    fz = axes > 2 ? point[2] : 0;
+        for (unsigned int k = 0; k < channels; k++) {
+            const int c =
+                axes == 4 ? gmicpy_pixel_cast<int>::cast(point[3]) : (int)k;
+            const T value =
+                values[p * values_step + (values_step > 1 ? k : 0)];
+            if (c < 0 || c >= image.spectrum()) {
+                continue;
             }
-            display_result =
-                PyObject_CallMethod(matplotlib_pyplot_module, "subplot", "iii",
-                                    nb_subplots, 1, matplotlib_subplot_id++);
-            if (!display_result) {
-                return display_result;
+            if (interpolation == GMICPY_INTERPOLATION_LINEAR) {
+                image.set_linear_atXYZ(value, fx, fy, fz, c);
+                continue;
             }
-
-            display_result = PyObject_CallMethod(matplotlib_pyplot_module,
-                                                 "imshow", "O", image);
-            if (!display_result) {
-                return display_result;
+            const int x = gmicpy_pixel_cast<int>::cast(fx),
+                      y = gmicpy_pixel_cast<int>::cast(fy),
+                      z = gmicpy_pixel_cast<int>::cast(fz);
+            if (x >= 0 && y >= 0 && z >= 0 && x < image.width() &&
+                y < image.height() && z < image.depth()) {
+                image(x, y, z, c) = value;
             }
         }
-        else if (use_ipython) {
-            image = PyObject_CallMethod(
-                ipython_display_module, "Image", "O",
-                PyList_GetItem(all_image_expanded_filenames, j));
-            if (image == NULL) {
-                return image;
+    }
+
+    Py_RETURN_NONE;
+}
+
+/* Parse a GmicImage subscript, ie. an int, a slice or a tuple of up to 4 of
+ * them along the x, y, z and c axes, into the [from, to) ranges of each
+ * axis. Missing axes are whole and ints keep their axis with a size of 1.
+ * Returns false with an IndexError or ValueError set otherwise. */
+static bool
+gmicpy_parse_region(const gmic_image<T> &image, PyObject *key,
+                    Py_ssize_t *from, Py_ssize_t *to)
+{
+    const Py_ssize_t shape[4] = {image._width, image._height, image._depth,
+                                 image._spectrum};
+    const char *axes_names = "xyzc";
+    Py_ssize_t keys_count = PyTuple_Check(key) ? PyTuple_GET_SIZE(key) : 1;
+    Py_ssize_t step = 1, length = 0;
+
+    if (keys_count > 4) {
+        PyErr_Format(PyExc_IndexError,
+                     "GmicImage subscripts have up to 4 (x, y, z, c) axes, "
+                     "%d found.",
+                     (int)keys_count);
+        return false;
+    }
+    for (int axis = 0; axis < 4; axis++) {
+        PyObject *axis_key = axis >= keys_count      ? NULL
+                             : PyTuple_Check(key) ? PyTuple_GET_ITEM(key, axis)
+                                                  : key;
+        from[axis] = 0;
+        to[axis] = shape[axis];
+        if (axis_key == NULL) {
+            continue;
+        }
+        if (PySlice_Check(axis_key)) {
+            if (PySlice_GetIndicesEx(axis_key, shape[axis], &from[axis],
+                                     &to[axis], &step, &length) < 0) {
+                return false;
             }
-            display_result = PyObject_CallMethod(ipython_display_module,
-                                                 "display", "O", image);
-            if (display_result == NULL) {
-                return display_result;
+            if (step != 1) {
+                PyErr_Format(PyExc_ValueError,
+                             "GmicImage slices along the %c axis must have "
+                             "a step of 1.",
+                             axes_names[axis]);
+                return false;
             }
+            if (length <= 0) {
+                PyErr_Format(PyExc_IndexError,
+                             "GmicImage slices along the %c axis must not "
+                             "be empty.",
+                             axes_names[axis]);
+                return false;
+            }
+            continue;
         }
-        else {
-            PyErr_Format(GmicException,
-                         "Logic error: matplotlib or ipython should have "
-                         "been imported at this point.");
-            return NULL;
+        from[axis] = PyNumber_AsSsize_t(axis_key, PyExc_IndexError);
+        if (from[axis] == -1 && PyErr_Occurred()) {
+            return false;
         }
-    }
-    // Matplolib requires only one single image display call, for multiple
-    // images
-    if (use_matplotlib) {
-        display_result =
-            PyObject_CallMethod(matplotlib_pyplot_module, "show", NULL);
-        if (!display_result) {
-            return display_result;
+        from[axis] += from[axis] < 0 ? shape[axis] : 0;
+        if (from[axis] < 0 || from[axis] >= shape[axis]) {
+            PyErr_Format(PyExc_IndexError,
+                         "GmicImage index out of range along the %c axis "
+                         "of size %d.",
+                         axes_names[axis], (int)shape[axis]);
+            return false;
         }
+        to[axis] = from[axis] + 1;
+    }
 
-        Py_XDECREF(all_image_expanded_filenames);
-        Py_XDECREF(image_expanded_filenames);
-        Py_XDECREF(image_glob_str);
-        Py_XDECREF(image);
+    return true;
+}
+
+/* GmicImage[x, y, z, c] sub-image. Regions contiguous in G'MIC's planar
+ * layout (eg. a range of channels, of slices or of lines of a single
+ * slice and channel) are views holding a buffer export on their parent, and
+ * other ones are cropped copies. */
+static PyObject *
+PyGmicImage_subscript(PyGmicImage *self, PyObject *key)
+{
+    const gmic_image<T> &image = *self->_gmic_image;
+    const Py_ssize_t shape[4] = {image._width, image._height, image._depth,
+                                 image._spectrum};
+    Py_ssize_t from[4], to[4];
+    Py_ssize_t offset = 0, stride = 1;
+    bool is_contiguous = true, has_partial_axis = false;
+    PyGmicImage *sub_image = NULL;
+
+    if (!gmicpy_parse_region(image, key, from, to)) {
+        return NULL;
+    }
+    // Axes following the first partial one must have a size of 1
+    for (int axis = 0; axis < 4; axis++) {
+        is_contiguous &= !has_partial_axis || to[axis] - from[axis] == 1;
+        has_partial_axis |= to[axis] - from[axis] != shape[axis];
+        offset += from[axis] * stride;
+        stride *= shape[axis];
     }
 
-    Py_XDECREF(ipython_display_module);
-    Py_XDECREF(matplotlib_pyplot_module);
-    Py_XDECREF(glob_module);
+    sub_image = (PyGmicImage *)PyGmicImageType.tp_alloc(&PyGmicImageType, 0);
+    if (sub_image == NULL) {
+        return NULL;
+    }
+    if (!is_contiguous) {
+        try {
+            *sub_image->_gmic_image =
+                image.get_crop((int)from[0], (int)from[1], (int)from[2],
+                               (int)from[3], (int)to[0] - 1, (int)to[1] - 1,
+                               (int)to[2] - 1, (int)to[3] - 1);
+        }
+        catch (...) {
+            Py_DECREF(sub_image);
+            return PyErr_NoMemory();
+        }
+        return (PyObject *)sub_image;
+    }
 
-    return display_result;
+    if (PyObject_GetBuffer((PyObject *)self, &sub_image->_owner_buffer,
+                           PyBUF_SIMPLE) < 0) {
+        sub_image->_owner_buffer.obj = NULL;
+        Py_DECREF(sub_image);
+        return NULL;
+    }
+    sub_image->_gmic_image->assign(
+        image._data + offset, (unsigned int)(to[0] - from[0]),
+        (unsigned int)(to[1] - from[1]), (unsigned int)(to[2] - from[2]),
+        (unsigned int)(to[3] - from[3]), true);
+
+    return (PyObject *)sub_image;
 }
 
-PyObject *
-autoload_wurlitzer_into_ipython()
+/* GmicImage[x, y, z, c] = value, writing a same-sized GmicImage or a single
+ * value into a region. */
+static int
+PyGmicImage_ass_subscript(PyGmicImage *self, PyObject *key, PyObject *value)
 {
-    PyObject *wurlitzer_module = NULL;
-    PyObject *ipython_module = NULL;
-    PyObject *ipython_handler = NULL;
-    PyObject *ipython_run_line_magic_result = NULL;
-    PyObject *ipython_loaded_extensions = NULL;
+    gmic_image<T> &image = *self->_gmic_image;
+    Py_ssize_t from[4], to[4];
+    T fill_value = 0;
+
+    if (value == NULL) {
+        PyErr_SetString(PyExc_TypeError,
+                        "GmicImage regions cannot be deleted.");
+        return -1;
+    }
+    if (!gmicpy_parse_region(image, key, from, to)) {
+        return -1;
+    }
 
-    if (cimg_OS == 1) {  // UNIX OSes
-        wurlitzer_module = PyImport_ImportModule("wurlitzer");
-        if (wurlitzer_module == NULL) {
-            PySys_WriteStdout(
-                "gmic-py: If you do not see any text for G'MIC "
-                "'print' or "
-                "'display' commands, you could '!pip install "
-                "wurlitzer' "
-                "and if under an IPython environment, run the "
-                "'%%load_ext "
-                "wurlitzer' macro. See "
-                "https://github.com/myselfhimself/gmic-py/issues/"
-                "64\n");
-            PyErr_Clear();
+    if (Py_TYPE(value) == (PyTypeObject *)&PyGmicImageType) {
+        const gmic_image<T> &sprite = *((PyGmicImage *)value)->_gmic_image;
+        if ((Py_ssize_t)sprite._width != to[0] - from[0] ||
+            (Py_ssize_t)sprite._height != to[1] - from[1] ||
+            (Py_ssize_t)sprite._depth != to[2] - from[2] ||
+            (Py_ssize_t)sprite._spectrum != to[3] - from[3]) {
+            PyErr_Format(PyExc_ValueError,
+                         "Cannot write a GmicImage of w=%d h=%d d=%d s=%d "
+                         "into a region of w=%d h=%d d=%d s=%d.",
+                         sprite._width, sprite._height, sprite._depth,
+                         sprite._spectrum, (int)(to[0] - from[0]),
+                         (int)(to[1] - from[1]), (int)(to[2] - from[2]),
+                         (int)(to[3] - from[3]));
+            return -1;
         }
-        else {  // if wurlitzer module could be imported
-            ipython_module = PyImport_ImportModule("IPython");
-            if (ipython_module == NULL) {
-                PyErr_Clear();
-                Py_RETURN_NONE;
-            }
-            else {  // If IPython module found
-                ipython_handler =
-                    PyObject_CallMethod(ipython_module, "get_ipython", NULL);
-                if (ipython_handler == NULL) {
-                    PyErr_Clear();
-                    return NULL;
-                }
-                // Skip any wurlitzer imported if not in an IPython context, or
-                // if an IPython terminal
-                else if (ipython_handler == Py_None ||
-                         !PyObject_HasAttrString(ipython_handler, "kernel")) {
-                    // See
-                    // https://github.com/myselfhimself/gmic-py/issues/63#issuecomment-703533397
-                    Py_XDECREF(ipython_handler);
-                    Py_XDECREF(wurlitzer_module);
-                    Py_XDECREF(ipython_module);
-                    Py_RETURN_NONE;
-                }
-                else {
-                    ipython_loaded_extensions = PyObject_GetAttrString(
-                        PyObject_GetAttrString(ipython_handler,
-                                               "extension_manager"),
-                        "loaded");
-                    if (ipython_loaded_extensions == NULL) {
-                        PyErr_Clear();
-                    }
-                    else {
-                        // if wurlitzer extension not loaded yet into
-                        // IPython, try to load it
-                        if (PySet_Contains(
-                                ipython_loaded_extensions,
-                                PyUnicode_FromString("wurlitzer")) == 0) {
-                            ipython_run_line_magic_result =
-                                PyObject_CallMethod(ipython_handler,
-                                                    "run_line_magic", "ss",
-                                                    "load_ext", "wurlitzer");
-                            if (ipython_run_line_magic_result == NULL) {
-                                PySys_WriteStdout(
-                                    "gmic-py: managed to find IPython "
-                                    "but "
-                                    "could not call the '%%load_ext "
-                                    "wurltizer "
-                                    "macro for you. If you '!pip "
-                                    "install "
-                                    "wurlitzer' or install "
-                                    "'wurlitzer' in "
-                                    "your virtual environment, "
-                                    "gmic-py will "
-                                    "try to load it for you "
-                                    "automatically.\n");
-                                PyErr_Clear();
-                            }
-                            else {
-                                PySys_WriteStderr(
-                                    "gmic-py: wurlitzer found (for "
-                                    "G'MIC "
-                                    "stdout/stderr redirection) and "
-                                    "enabled "
-                                    "automatically through IPython "
-                                    "'%%load_ext wurlitzer'.\n");
-                            }
-                        }
-                    }
-                }
+        // Overlapping views of a same image are taken care of by CImg
+        image.draw_image((int)from[0], (int)from[1], (int)from[2],
+                         (int)from[3], sprite);
+        return 0;
+    }
+
+    fill_value = (T)PyFloat_AsDouble(value);
+    if (PyErr_Occurred()) {
+        PyErr_Format(PyExc_TypeError,
+                     "GmicImage regions can only be set to a '%.400s' or a "
+                     "number, not to a '%.50s'.",
+                     PyGmicImageType.tp_name, Py_TYPE(value)->tp_name);
+        return -1;
+    }
+    for (Py_ssize_t c = from[3]; c < to[3]; c++) {
+        for (Py_ssize_t z = from[2]; z < to[2]; z++) {
+            for (Py_ssize_t y = from[1]; y < to[1]; y++) {
+                T *line = image.data((unsigned int)from[0], (unsigned int)y,
+                                     (unsigned int)z, (unsigned int)c);
+                std::fill(line, line + (to[0] - from[0]), fill_value);
             }
         }
     }
-    else {  // Non-UNIX OSes
-        PySys_WriteStdout(
-            "You are not on a UNIX-like OS and unless you do "
-            "have a "
-            "side-window console, you shall not see any text "
-            "for "
-            "G'MIC 'print' or 'display' commands output. Hope "
-            "you can "
-            "accept it so. See "
-            "https://github.com/myselfhimself/gmic-py/issues/"
-            "64\n");
+
+    return 0;
+}
+
+static PyMappingMethods PyGmicImage_as_mapping = {
+    NULL,                                      // mp_length
+    (binaryfunc)PyGmicImage_subscript,         // mp_subscript
+    (objobjargproc)PyGmicImage_ass_subscript,  // mp_ass_subscript
+};
+
+static PyObject *
+PyGmicImage_alloc(PyTypeObject *type, Py_ssize_t nitems)
+{
+    PyObject *obj = (PyObject *)PyObject_Malloc(type->tp_basicsize);
+    ((PyGmicImage *)obj)->_gmic_image = new gmic_image<T>();
+    ((PyGmicImage *)obj)->_exports = 0;
+    ((PyGmicImage *)obj)->_owner_buffer.obj = NULL;
+    GMIC_PY_LOG("PyGmicImage_alloc\n");
+    PyObject_Init(obj, type);
+    return obj;
+}
+
+static PyObject *
+PyGmic_alloc(PyTypeObject *type, Py_ssize_t nitems)
+{
+    PyObject *obj = (PyObject *)PyObject_Malloc(type->tp_basicsize);
+    if (obj == NULL) {
+        return PyErr_NoMemory();
+    }
+    ((PyGmic *)obj)->_lock = PyThread_allocate_lock();
+    if (((PyGmic *)obj)->_lock == NULL) {
+        PyObject_Free(obj);
+        return PyErr_NoMemory();
+    }
+    // Without the built-in commands, which PyGmic_new() adds from the
+    // process-wide cached commands files
+    try {
+        ((PyGmic *)obj)->_gmic =
+            new gmic((const char *)0, (const char *)0, false, (float *)0,
+                     (bool *)0, (T)0);
+    }
+    catch (...) {
+        PyThread_free_lock(((PyGmic *)obj)->_lock);
+        PyObject_Free(obj);
+        return PyErr_NoMemory();
     }
+    ((PyGmic *)obj)->_batch_interpreters = NULL;
+    // Atomics are constructed in place, since the object's memory comes
+    // from PyObject_Malloc()
+    new (&((PyGmic *)obj)->_is_abort) std::atomic<bool>(false);
+    new (&((PyGmic *)obj)->_entered_runs) std::atomic<unsigned long>(0);
+    new (&((PyGmic *)obj)->_aborted_runs) std::atomic<unsigned long>(0);
+    new (&((PyGmic *)obj)->_progress) std::atomic<float>(-1);
+    ((PyGmic *)obj)->_max_memory = 0;
+    GMIC_PY_LOG("PyGmic_alloc\n");
+    PyObject_Init(obj, type);
+    return obj;
+}
 
-    Py_XDECREF(wurlitzer_module);
-    Py_XDECREF(ipython_module);
-    Py_XDECREF(ipython_handler);
-    Py_XDECREF(ipython_run_line_magic_result);
-    return ipython_run_line_magic_result;
+static void
+PyGmicImage_free(PyObject *v)
+{
+    PyObject_Free(v);
+}
+
+static void
+PyGmic_free(PyObject *v)
+{
+    PyObject_Free(v);
+}
+
+static void
+PyGmicImage_dealloc(PyGmicImage *self)
+{
+    delete self->_gmic_image;
+    self->_gmic_image = NULL;
+    gmicpy_gmic_image_release_owner(self);
+    GMIC_PY_LOG("PyGmicImage_dealloc\n");
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
+
+static void
+PyGmic_dealloc(PyGmic *self)
+{
+    delete self->_gmic;
+    self->_gmic = NULL;
+    PyThread_free_lock(self->_lock);
+    self->_lock = NULL;
+    Py_CLEAR(self->_batch_interpreters);
+    // keep this in place for test_gmic_py_memfreeing.py pytest case
+    GMIC_PY_LOG("PyGmic_dealloc\n");
+    Py_TYPE(self)->tp_free((PyObject *)self);
 }
 
-// end gmic_py_jupyter_ipython_display
-#endif
+//------- G'MIC INTERPRETERS POOL BINDING ----------//
 
-static PyObject *
-run_impl(PyObject *self, PyObject *args, PyObject *kwargs)
+PyObject *
+PyGmicPool_new(PyTypeObject *subtype, PyObject *args, PyObject *kwargs)
 {
-    char const *keywords[] = {"command", "images", "image_names", "nodisplay",
-                              NULL};
-    PyObject *input_gmic_images = NULL;
-    PyObject *input_gmic_image_names = NULL;
-    char *commands_line = NULL;
-    int image_position = 0;
-    int image_name_position = 0;
-    int image_names_count = 0;
-    gmic_list<T> images;
-    gmic_list<char> image_names;  // Empty image names
-    char *current_image_name_raw = NULL;
-    PyObject *current_image = NULL;
-    PyObject *current_image_name = NULL;
-    PyObject *iter = NULL;
-#ifdef gmic_py_jupyter_ipython_display
-    static bool no_display_checked = false;
-    static bool no_display_available = false;
-    PyObject *commands_line_display_to_ouput_result = NULL;
-    PyObject *ipython_matplotlib_display_result = NULL;
-#endif
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s|OO", (char **)keywords,
-                                     &commands_line, &input_gmic_images,
-                                     &input_gmic_image_names)) {
+    char const *keywords[] = {"size", NULL};
+    Py_ssize_t size = 0;  // Defaults to the number of CPU cores
+    PyGmicPool *self = NULL;
+    PyObject *futures_module = NULL;
+    PyObject *interpreter = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|n", (char **)keywords,
+                                     &size)) {
         return NULL;
     }
 
-    try {
-        Py_XINCREF(input_gmic_images);
-        Py_XINCREF(input_gmic_image_names);
+    if (size == 0) {
+        size = (Py_ssize_t)std::thread::hardware_concurrency();
+        size = size > 0 ? size : 1;
+    }
+    else if (size < 0) {
+        PyErr_Format(PyExc_ValueError,
+                     "'size' parameter must be a positive number of "
+                     "interpreters, %zd found.",
+                     size);
+        return NULL;
+    }
 
-#ifdef gmic_py_jupyter_ipython_display
-        // Use a special way of displaying images only if the OS's display
-        // is not available
-        if (!no_display_checked) {
-            no_display_checked = true;
-            no_display_available = (getenv("DISPLAY") == NULL);
-            if (no_display_available) {
-                PySys_WriteStdout("gmic-py: Working in display-less mode.\n");
-            }
+    if (!(futures_module = PyImport_ImportModule("concurrent.futures"))) {
+        return NULL;
+    }
+
+    self = (PyGmicPool *)subtype->tp_alloc(subtype, 0);
+    if (self == NULL) {
+        Py_DECREF(futures_module);
+        return NULL;
+    }
+
+    self->_interpreters = PyTuple_New(size);
+    self->_idle_interpreters = PyList_New(0);
+    if (self->_interpreters == NULL || self->_idle_interpreters == NULL) {
+        Py_DECREF(futures_module);
+        Py_DECREF(self);
+        return NULL;
+    }
+
+    // Warm up all interpreters once, so that requests never pay for
+    // G'MIC's resources and commands loading
+    for (Py_ssize_t i = 0; i < size; i++) {
+        interpreter = PyObject_CallObject((PyObject *)&PyGmicType, NULL);
+        if (interpreter == NULL) {
+            Py_DECREF(futures_module);
+            Py_DECREF(self);
+            return NULL;
         }
+        PyTuple_SET_ITEM(self->_interpreters, i, interpreter);
+        PyList_Append(self->_idle_interpreters, interpreter);
+    }
 
-        if (no_display_available) {
-            // Provide a fallback for gmic "display" command (without
-            // supporting arguments) The idea is to replace all
-            // occurences of "display" by "display output someprefix.png"
-            commands_line_display_to_ouput_result =
-                gmic_py_str_replace_display_to_output(commands_line,
-                                                      (char *)".png");
-            if (commands_line_display_to_ouput_result == NULL) {
-                Py_XDECREF(input_gmic_images);
-                Py_XDECREF(input_gmic_image_names);
-                // Pass exception upwards
-                return NULL;
-            }
-            commands_line = (char *)PyUnicode_AsUTF8(
-                PyList_GetItem(commands_line_display_to_ouput_result, 0));
+    self->_executor = PyObject_CallMethod(
+        futures_module, "ThreadPoolExecutor", "n", size);
+    Py_DECREF(futures_module);
+    if (self->_executor == NULL) {
+        Py_DECREF(self);
+        return NULL;
+    }
+
+    return (PyObject *)self;
+}
+
+static void
+PyGmicPool_dealloc(PyGmicPool *self)
+{
+    PyObject *error_type = NULL;
+    PyObject *error_value = NULL;
+    PyObject *error_traceback = NULL;
+    PyObject *shutdown_result = NULL;
+
+    // Let the executor's idle worker threads exit
+    if (self->_executor != NULL) {
+        PyErr_Fetch(&error_type, &error_value, &error_traceback);
+        shutdown_result = PyObject_CallMethod(self->_executor, "shutdown",
+                                              "O", Py_False);
+        if (shutdown_result == NULL) {
+            PyErr_Clear();
         }
-#endif
+        Py_XDECREF(shutdown_result);
+        PyErr_Restore(error_type, error_value, error_traceback);
+    }
 
-        // Grab image names or single image name and check typings
-        if (input_gmic_image_names != NULL) {
-            // If list of image names provided
-            if (PyList_Check(input_gmic_image_names)) {
-                PyObject *iter = PyObject_GetIter(input_gmic_image_names);
-                image_names_count = Py_SIZE(input_gmic_image_names);
-                image_names.assign(image_names_count);
-                image_name_position = 0;
-
-                while ((current_image_name = PyIter_Next(iter))) {
-                    if (!PyUnicode_Check(current_image_name)) {
-                        PyErr_Format(PyExc_TypeError,
-                                     "'%.50s' input element found at position "
-                                     "%d in "
-                                     "'image_names' list is not a '%.400s'",
-                                     Py_TYPE(current_image_name)->tp_name,
-                                     image_name_position,
-                                     PyUnicode_Type.tp_name);
-                        Py_XDECREF(input_gmic_images);
-                        Py_XDECREF(input_gmic_image_names);
-
-                        return NULL;
-                    }
+    Py_CLEAR(self->_executor);
+    Py_CLEAR(self->_idle_interpreters);
+    Py_CLEAR(self->_interpreters);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
 
-                    current_image_name_raw =
-                        (char *)PyUnicode_AsUTF8(current_image_name);
-                    image_names[image_name_position].assign(
-                        strlen(current_image_name_raw) + 1);
-                    memcpy(image_names[image_name_position]._data,
-                           current_image_name_raw,
-                           image_names[image_name_position]._width);
-                    image_name_position++;
-                }
+static PyObject *
+PyGmicPool_repr(PyGmicPool *self)
+{
+    return PyUnicode_FromFormat("<%s object at %p with %zd interpreters>",
+                                Py_TYPE(self)->tp_name, self,
+                                PyTuple_GET_SIZE(self->_interpreters));
+}
 
-                // If single image name provided
-            }
-            else if (PyUnicode_Check(input_gmic_image_names)) {
-                // Enforce also non-null single-GmicImage 'images'
-                // parameter
-                if (input_gmic_images != NULL &&
-                    Py_TYPE(input_gmic_images) !=
-                        (PyTypeObject *)&PyGmicImageType) {
-                    PyErr_Format(PyExc_TypeError,
-                                 "'%.50s' 'images' parameter must be a "
-                                 "'%.400s' if the "
-                                 "'image_names' parameter is a bare '%.400s'.",
-                                 Py_TYPE(input_gmic_images)->tp_name,
-                                 PyGmicImageType.tp_name,
-                                 PyUnicode_Type.tp_name);
-                    Py_XDECREF(input_gmic_images);
-                    Py_XDECREF(input_gmic_image_names);
+/* Run on an idle interpreter of the pool. This is called from the pool's
+ * worker threads. Returns the 'images' parameter after the run, or None. */
+static PyObject *
+PyGmicPool__run(PyGmicPool *self, PyObject *args, PyObject *kwargs)
+{
+    PyObject *interpreter = NULL;
+    PyObject *run_result = NULL;
+    bool is_idle_interpreter = false;
+
+    // Picking an interpreter while holding the GIL is atomic. There are as
+    // many worker threads as interpreters, so one is always idle.
+    if (PyList_GET_SIZE(self->_idle_interpreters) > 0) {
+        is_idle_interpreter = true;
+        interpreter = PySequence_GetItem(
+            self->_idle_interpreters,
+            PyList_GET_SIZE(self->_idle_interpreters) - 1);
+        PySequence_DelItem(self->_idle_interpreters,
+                           PyList_GET_SIZE(self->_idle_interpreters) - 1);
+    }
+    else {
+        // Fallback if shared outside of the executor: runs get serialized
+        // by the interpreter's lock
+        interpreter = PyTuple_GET_ITEM(self->_interpreters, 0);
+        Py_INCREF(interpreter);
+    }
 
-                    return NULL;
-                }
+    run_result = run_impl_returning_images(interpreter, args, kwargs);
 
-                image_names.assign(1);
-                current_image_name_raw =
-                    (char *)PyUnicode_AsUTF8(input_gmic_image_names);
-                image_names[0].assign(strlen(current_image_name_raw) + 1);
-                memcpy(image_names[0]._data, current_image_name_raw,
-                       image_names[0]._width);
-                // If neither a list of strings nor a single string
-                // were provided, raise exception
-            }
-            else {
-                PyErr_Format(PyExc_TypeError,
-                             "'%.50s' 'image_names' parameter must be a list "
-                             "of '%.400s'(s)",
-                             Py_TYPE(input_gmic_image_names)->tp_name,
-                             PyUnicode_Type.tp_name);
-                Py_XDECREF(input_gmic_images);
-                Py_XDECREF(input_gmic_image_names);
+    // Only interpreters taken from the idle list go back into it
+    if (is_idle_interpreter) {
+        PyList_Append(self->_idle_interpreters, interpreter);
+    }
+    Py_DECREF(interpreter);
 
-                return NULL;
-            }
-        }
+    return run_result;
+}
 
-        if (input_gmic_images != NULL) {
-            // A/ If a list of images was provided
-            if (PyList_Check(input_gmic_images)) {
-                image_position = 0;
-                images.assign(Py_SIZE(input_gmic_images));
-
-                // Grab images into a proper gmic_list after checking
-                // their typing
-                iter = PyObject_GetIter(input_gmic_images);
-                while ((current_image = PyIter_Next(iter))) {
-                    // If gmic_list item type is not a GmicImage
-                    if (Py_TYPE(current_image) !=
-                        (PyTypeObject *)&PyGmicImageType) {
-                        PyErr_Format(PyExc_TypeError,
-                                     "'%.50s' input object found at "
-                                     "position %d in "
-                                     "'images' list is not a '%.400s'",
-                                     Py_TYPE(current_image)->tp_name,
-                                     image_position, PyGmicImageType.tp_name);
-
-                        Py_XDECREF(input_gmic_images);
-                        Py_XDECREF(input_gmic_image_names);
-
-                        return NULL;
-                    }
-                    // Fill our just created gmic_list at same index
-                    // with gmic_image coming from Python
-                    swap_gmic_image_into_gmic_list(
-                        (PyGmicImage *)current_image, images, image_position);
+static PyObject *
+PyGmicPool_submit(PyGmicPool *self, PyObject *args, PyObject *kwargs)
+{
+    PyObject *submit_args = NULL;
+    PyObject *run_method = NULL;
+    PyObject *executor_submit = NULL;
+    PyObject *future = NULL;
 
-                    image_position++;
-                }
+    if (PyTuple_GET_SIZE(args) == 0 &&
+        (kwargs == NULL || PyDict_GetItemString(kwargs, "command") == NULL)) {
+        PyErr_Format(PyExc_TypeError,
+                     "submit() missing required argument 'command'");
+        return NULL;
+    }
 
-                // Process images and names
-                ((PyGmic *)self)
-                    ->_gmic->run(commands_line, images, image_names, 0, 0);
-
-                // Prevent images auto-deallocation by G'MIC
-                image_position = 0;
-
-                // Bring new images set back into the Python world
-                // (change List items in-place) First empty the input
-                // Python images List object from its items without
-                // deleting it (empty list, same reference)
-                PySequence_DelSlice(input_gmic_images, 0,
-                                    PySequence_Length(input_gmic_images));
-
-                cimglist_for(images, l)
-                {
-                    // On the fly python GmicImage build per
-                    // https://stackoverflow.com/questions/4163018/create-an-object-using-pythons-c-api/4163055#comment85217110_4163055
-                    PyObject *_data = PyBytes_FromStringAndSize(
-                        (const char *)images[l]._data,
-                        (Py_ssize_t)sizeof(T) * images[l].size());
-                    PyObject *new_gmic_image = NULL;
-
-                    new_gmic_image = PyObject_CallFunction(
-                        (PyObject *)&PyGmicImageType,
-                        // The last argument is a p(redicate), ie.
-                        // boolean..
-                        // but Py_BuildValue() used by
-                        // PyObject_CallFunction has a slightly
-                        // different parameters format specification
-                        (const char *)"SIIIIi", _data,
-                        (unsigned int)images[l]._width,
-                        (unsigned int)images[l]._height,
-                        (unsigned int)images[l]._depth,
-                        (unsigned int)images[l]._spectrum,
-                        (int)images[l]._is_shared);
-                    if (new_gmic_image == NULL) {
-                        PyErr_Format(
-                            PyExc_RuntimeError,
-                            "Could not initialize GmicImage for "
-                            "appending "
-                            "it to provided 'images' parameter list.");
-                        return NULL;
-                    }
+    // executor.submit(self._run, *args, **kwargs)
+    run_method = PyObject_GetAttrString((PyObject *)self, "_run");
+    executor_submit = PyObject_GetAttrString(self->_executor, "submit");
+    submit_args = PyTuple_New(PyTuple_GET_SIZE(args) + 1);
+    if (run_method == NULL || executor_submit == NULL || submit_args == NULL) {
+        Py_XDECREF(run_method);
+        Py_XDECREF(executor_submit);
+        Py_XDECREF(submit_args);
+        return NULL;
+    }
+    PyTuple_SET_ITEM(submit_args, 0, run_method);
+    for (Py_ssize_t i = 0; i < PyTuple_GET_SIZE(args); i++) {
+        Py_INCREF(PyTuple_GET_ITEM(args, i));
+        PyTuple_SET_ITEM(submit_args, i + 1, PyTuple_GET_ITEM(args, i));
+    }
 
-                    PyList_Append(input_gmic_images, new_gmic_image);
-                }
+    future = PyObject_Call(executor_submit, submit_args, kwargs);
 
-                // B/ Else if a single GmicImage was provided
-            }
-            else if (Py_TYPE(input_gmic_images) ==
-                     (PyTypeObject *)&PyGmicImageType) {
-                images.assign(1);
-                swap_gmic_image_into_gmic_list(
-                    (PyGmicImage *)input_gmic_images, images, 0);
-
-                // Pipe the commands, our single image, and no image
-                // names
-                ((PyGmic *)self)
-                    ->_gmic->run(commands_line, images, image_names, 0, 0);
-
-                // Alter the original image only if the gmic_image list
-                // has not been downsized to 0 elements this may happen
-                // with eg. a rm[0] G'MIC command We must prevent this,
-                // because a 'core dumped' happens otherwise
-                if (images.size() > 0) {
-                    swap_gmic_list_item_into_gmic_image(
-                        images, 0, (PyGmicImage *)input_gmic_images);
-                }
-                else {
-                    PyErr_Format(PyExc_RuntimeError,
-                                 "'%.50s' 'images' single-element parameter "
-                                 "was removed by your G\'MIC command. It was "
-                                 "probably emptied, your optional "
-                                 "'image_names' list is untouched.",
-                                 Py_TYPE(input_gmic_images)->tp_name,
-                                 PyGmicImageType.tp_name,
-                                 PyGmicImageType.tp_name);
-                    Py_XDECREF(input_gmic_images);
-                    Py_XDECREF(input_gmic_image_names);
+    Py_DECREF(executor_submit);
+    Py_DECREF(submit_args);
 
-                    return NULL;
-                }
-            }
-            // Else if provided 'images' type is unknown, raise Error
-            else {
-                PyErr_Format(PyExc_TypeError,
-                             "'%.50s' 'images' parameter must be a "
-                             "'%.400s', or list "
-                             "of either '%.400s'(s)",
-                             Py_TYPE(input_gmic_images)->tp_name,
-                             PyGmicImageType.tp_name, PyGmicImageType.tp_name);
-                Py_XDECREF(input_gmic_images);
-                Py_XDECREF(input_gmic_image_names);
+    return future;
+}
 
-                return NULL;
-            }
+static PyObject *
+PyGmicPool_map(PyGmicPool *self, PyObject *args, PyObject *kwargs)
+{
+    char const *keywords[] = {"command", "images_sets", "image_names_sets",
+                              NULL};
+    PyObject *command = NULL;
+    PyObject *images_sets = NULL;
+    PyObject *image_names_sets = NULL;
+    PyObject *images_iter = NULL;
+    PyObject *image_names_iter = NULL;
+    PyObject *current_images = NULL;
+    PyObject *current_image_names = NULL;
+    PyObject *submit_args = NULL;
+    PyObject *future = NULL;
+    PyObject *futures = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "UO|O", (char **)keywords,
+                                     &command, &images_sets,
+                                     &image_names_sets)) {
+        return NULL;
+    }
 
-            // If a correctly-typed image names parameter was provided,
-            // even if wrongly typed, let us update its Python object
-            // in place, to mirror any kind of changes that may have
-            // taken place in the gmic_list of image names
-            if (input_gmic_image_names != NULL) {
-                // i) If a list parameter was provided
-                if (PyList_Check(input_gmic_image_names)) {
-                    // First empty the input Python image names list
-                    PySequence_DelSlice(
-                        input_gmic_image_names, 0,
-                        PySequence_Length(input_gmic_image_names));
-                    // Add image names from the Gmic List of names
-                    cimglist_for(image_names, l)
-                    {
-                        PyList_Append(input_gmic_image_names,
-                                      PyUnicode_FromString(image_names[l]));
-                    }
-                }
-                // ii) If a str parameter was provided
-                // Because of Python's string immutability, we will not
-                // change the input string's content here :) :/
-            }
+    if (!(images_iter = PyObject_GetIter(images_sets))) {
+        return NULL;
+    }
+    if (image_names_sets != NULL && image_names_sets != Py_None &&
+        !(image_names_iter = PyObject_GetIter(image_names_sets))) {
+        Py_DECREF(images_iter);
+        return NULL;
+    }
+
+    futures = PyList_New(0);
+    while (futures != NULL && (current_images = PyIter_Next(images_iter))) {
+        current_image_names =
+            image_names_iter != NULL ? PyIter_Next(image_names_iter) : NULL;
+        if (current_image_names != NULL) {
+            submit_args = PyTuple_Pack(3, command, current_images,
+                                       current_image_names);
         }
-        else {  // If no gmic_images given
-            T pixel_type;
-            ((PyGmic *)self)
-                ->_gmic->run((const char *const)commands_line,
-                             (float *const)NULL, (bool *const)NULL,
-                             (const T &)pixel_type);
+        else {
+            submit_args = PyTuple_Pack(2, command, current_images);
         }
+        future = PyGmicPool_submit(self, submit_args, NULL);
+
+        Py_DECREF(submit_args);
+        Py_DECREF(current_images);
+        Py_XDECREF(current_image_names);
 
-        Py_XDECREF(input_gmic_images);
-        Py_XDECREF(input_gmic_image_names);
+        if (future == NULL) {
+            Py_CLEAR(futures);
+            break;
+        }
+        PyList_Append(futures, future);
+        Py_DECREF(future);
     }
-    catch (gmic_exception &e) {
-        PyErr_SetString(GmicException, e.what());
+
+    Py_DECREF(images_iter);
+    Py_XDECREF(image_names_iter);
+    if (PyErr_Occurred()) {
+        Py_XDECREF(futures);
         return NULL;
     }
-    catch (std::exception &e) {
-        PyErr_SetString(GmicException, e.what());
+
+    return futures;
+}
+
+static PyObject *
+PyGmicPool_shutdown(PyGmicPool *self, PyObject *args, PyObject *kwargs)
+{
+    char const *keywords[] = {"wait", NULL};
+    int wait = 1;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|p", (char **)keywords,
+                                     &wait)) {
         return NULL;
     }
-#ifdef gmic_py_jupyter_ipython_display
-    // Use a special way of displaying only if the OS's display is not
-    // available
-    if (no_display_available) {
-        // Provide a fallback for gmic "display" command (without
-        // supporting arguments) The idea is to replace all occurences
-        // of "display" by "output someprefix.png display in ipython
-        ipython_matplotlib_display_result =
-            gmic_py_display_with_matplotlib_or_ipython(
-                PyList_GetItem(commands_line_display_to_ouput_result, 1));
-        if (ipython_matplotlib_display_result == NULL) {
-            // If we are not within a IPython environment, this is OK
-            // Let us just print the exception without throwing it further
-            // This case typically happens in readthedocs.org for gmic-sphinx
-            PyErr_Print();
-        }
-    }
-    Py_XDECREF(commands_line_display_to_ouput_result);
-    Py_XDECREF(ipython_matplotlib_display_result);
-#endif
 
-    Py_RETURN_NONE;
+    return PyObject_CallMethod(self->_executor, "shutdown", "O",
+                               wait ? Py_True : Py_False);
 }
 
-#ifdef gmic_py_numpy
-/**
- * Predictable Python 3.x 'numpy' module importer.
- */
-PyObject *
-import_numpy_module()
+static PyObject *
+PyGmicPool__enter__(PyGmicPool *self, PyObject *args)
 {
-    PyObject *numpy_module = PyImport_ImportModule("numpy");
+    Py_INCREF(self);
+    return (PyObject *)self;
+}
 
-    // exit raising numpy_module import exception
-    if (!numpy_module) {
-        PyErr_Clear();
-        return PyErr_Format(GmicException,
-                            "The 'numpy' module cannot be imported. Is it "
-                            "installed or in your Python path?");
+static PyObject *
+PyGmicPool__exit__(PyGmicPool *self, PyObject *args)
+{
+    PyObject *shutdown_result =
+        PyObject_CallMethod(self->_executor, "shutdown", "O", Py_True);
+
+    if (shutdown_result == NULL) {
+        return NULL;
     }
+    Py_DECREF(shutdown_result);
 
-    return numpy_module;
+    Py_RETURN_FALSE;
 }
 
-/*
- * GmicImage class method from_numpy_helper().
- * This factory class method generates a G'MIC Image from a
- * numpy.ndarray.
- *
- *  GmicImage.from_numpy_helper(obj: numpy.ndarray, deinterleave=True,
- * permute="xyzc": bool) -> GmicImage
- */
 static PyObject *
-PyGmicImage_from_numpy_helper(PyObject *cls, PyObject *args, PyObject *kwargs)
+PyGmicPool_get_size(PyGmicPool *self, void *closure)
 {
-    PyObject *py_arg_deinterleave = NULL;
-    PyObject *py_arg_deinterleave_default =
-        Py_True;  // Will deinterleave the incoming numpy.ndarray by default
-    PyObject *py_arg_ndarray = NULL;
-    PyObject *ndarray_type = NULL;
-    unsigned int ndarray_ndim = 0;
-    PyObject *ndarray_dtype = NULL;
-    PyObject *ndarray_dtype_kind = NULL;
-    PyObject *float32_ndarray = NULL;
-    PyObject *ndarray_as_3d_unsqueezed_view = NULL;
-    PyObject *ndarray_as_3d_unsqueezed_view_expanded_dims = NULL;
-    PyObject *ndarray_shape_tuple = NULL;
-    unsigned int _width = 1, _height = 1, _depth = 1, _spectrum = 1;
-    PyObject *numpy_module = NULL;
-    PyObject *ndarray_data_bytesObj = NULL;
-    T *ndarray_data_bytesObj_ptr = NULL;
-    char const *keywords[] = {"numpy_array", "deinterleave", "permute", NULL};
-    PyGmicImage *py_gmicimage_to_fill = NULL;
-    char *arg_permute = NULL;
+    return PyLong_FromSsize_t(PyTuple_GET_SIZE(self->_interpreters));
+}
+
+PyDoc_STRVAR(
+    PyGmicPool_doc,
+    "GmicPool(size=0)\n\n\
+Pool of warm G'MIC interpreters, running requests in parallel on idle ones.\n\n\
+Each ``gmic.Gmic`` instance pays once for G'MIC's resources and commands loading. A pool does it ``size`` times at creation, then hands every request to an idle interpreter from a worker thread. Since G'MIC runs without the GIL, requests use as many CPU cores as the pool has interpreters.\n\n\
+Example:\n\
+    Several ways to use a pool::\n\n\
+        import gmic\n\
+        with gmic.GmicPool(4) as pool:\n\
+            images = []\n\
+            future = pool.submit('sp apples blur 2', images)\n\
+            future.result() is images # True, the list was filled by G'MIC\n\
+            frames = [[gmic.GmicImage.from_numpy(f)] for f in my_numpy_frames]\n\
+            for f in pool.map('blur 2 sharpen 50', frames):\n\
+                print(f.result())\n\n\
+Args:\n\
+    size (Optional[int]): Number of interpreters and worker threads. Defaults to 0, ie. the number of CPU cores.\n\n\
+Raises:\n\
+    GmicException: If an interpreter cannot be created.");
+
+PyDoc_STRVAR(PyGmicPool_submit_doc,
+             "GmicPool.submit(command, images=None, image_names=None)\n\n\
+Schedule a ``Gmic.run`` call with the same parameters on an idle interpreter of the pool.\n\n\
+Args:\n\
+    command (str): An image-processing command in the G'MIC language\n\
+    images (Optional[Union[List[gmic.GmicImage], gmic.GmicImage]]): A list of ``GmicImage`` items that G'MIC will edit in place, or a single ``gmic.GmicImage``. Do not touch it until the run is done.\n\
+    image_names (Optional[List<str>]): A list of names for the images, defaults to None.\n\
+\n\
+Returns:\n\
+    concurrent.futures.Future: A future whose result is the ``images`` parameter once G'MIC is done with it (or ``None``), or which raises the run's ``GmicException``.");
+
+PyDoc_STRVAR(PyGmicPool_map_doc,
+             "GmicPool.map(command, images_sets, image_names_sets=None)\n\n\
+Schedule one ``Gmic.run`` call of a same command per item of ``images_sets``, spread over the pool's interpreters.\n\n\
+Args:\n\
+    command (str): An image-processing command in the G'MIC language\n\
+    images_sets (Iterable[Union[List[gmic.GmicImage], gmic.GmicImage]]): ``images`` parameters, one per run.\n\
+    image_names_sets (Optional[Iterable[List<str>]]): ``image_names`` parameters, one per run. Defaults to None.\n\
+\n\
+Returns:\n\
+    List[concurrent.futures.Future]: One future per run, in ``images_sets`` order. See ``GmicPool.submit``.");
+
+PyDoc_STRVAR(PyGmicPool_shutdown_doc,
+             "GmicPool.shutdown(wait=True)\n\n\
+Stop accepting requests and free the worker threads once pending requests are done.\n\n\
+Args:\n\
+    wait (Optional[bool]): Whether to block until pending requests are done. Defaults to True.");
+
+static PyMethodDef PyGmicPool_methods[] = {
+    {"submit", (PyCFunction)PyGmicPool_submit, METH_VARARGS | METH_KEYWORDS,
+     PyGmicPool_submit_doc},
+    {"map", (PyCFunction)PyGmicPool_map, METH_VARARGS | METH_KEYWORDS,
+     PyGmicPool_map_doc},
+    {"shutdown", (PyCFunction)PyGmicPool_shutdown,
+     METH_VARARGS | METH_KEYWORDS, PyGmicPool_shutdown_doc},
+    {"_run", (PyCFunction)PyGmicPool__run, METH_VARARGS | METH_KEYWORDS,
+     "Run on an idle interpreter of the pool, from a worker thread."},
+    {"__enter__", (PyCFunction)PyGmicPool__enter__, METH_NOARGS,
+     "Context manager support."},
+    {"__exit__", (PyCFunction)PyGmicPool__exit__, METH_VARARGS,
+     "Context manager support, shuts the pool down."},
+    {NULL} /* Sentinel */
+};
+
+PyGetSetDef PyGmicPool_getsets[] = {
+    {(char *)"size", (getter)PyGmicPool_get_size, NULL,
+     "Number of interpreters", NULL},
+    {NULL}};
+
+//------- G'MIC FRAMES STREAM BINDING ----------//
+
+/* Native side of a gmic.GmicStream. Frames alternate between two slots: while
+ * the worker thread runs G'MIC on one slot, the next frame is converted into
+ * the other one. Slot buffers are reused from frame to frame. */
+struct gmicpy_stream_state {
+    std::string command;
+    gmicpy_run_options options;
+    gmic_list<T> images[2];
+    gmic_list<char> image_names[2];
+    gmicpy_run_status statuses[2];
+    gmicpy_run_report reports[2];
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable condition;
+    int job_slot;      // Slot the worker should run next, or -1
+    int done_slot;     // Slot the worker last ran, or -1
+    int running_slot;  // Slot submitted and not yet collected, or -1
+    bool is_quitting;
+    bool is_started;
+
+    gmicpy_stream_state()
+        : job_slot(-1),
+          done_slot(-1),
+          running_slot(-1),
+          is_quitting(false),
+          is_started(false)
+    {
+    }
+};
+
+/* Worker thread body: run G'MIC on each submitted slot. Never touches
+ * Python. */
+static void
+gmicpy_stream_work(PyGmic *interpreter, gmicpy_stream_state *state)
+{
+    std::unique_lock<std::mutex> lock(state->mutex);
+    for (;;) {
+        state->condition.wait(lock, [&]() {
+            return state->job_slot >= 0 || state->is_quitting;
+        });
+        if (state->is_quitting) {
+            break;
+        }
+        int slot = state->job_slot;
+        state->job_slot = -1;
+        lock.unlock();
+        state->statuses[slot] = PyGmic_run_nogil_locked(
+            interpreter, state->command.c_str(), state->images[slot],
+            state->image_names[slot], state->options, state->reports[slot]);
+        lock.lock();
+        state->done_slot = slot;
+        state->condition.notify_all();
+    }
+}
 
-    numpy_module = import_numpy_module();
-    if (!numpy_module)
-        return NULL;
+static void
+gmicpy_stream_submit(gmicpy_stream_state *state, int slot)
+{
+    {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        state->reports[slot] = gmicpy_run_report();
+        state->done_slot = -1;
+        state->job_slot = slot;
+        state->running_slot = slot;
+    }
+    state->condition.notify_all();
+}
 
-    ndarray_type = PyObject_GetAttrString(numpy_module, "ndarray");
+/* Wait for the running slot's run to be done, without the GIL held. */
+static int
+gmicpy_stream_wait(gmicpy_stream_state *state)
+{
+    int slot = state->running_slot;
 
-    if (!PyArg_ParseTupleAndKeywords(
-            args, kwargs, (const char *)"O!|O!s", (char **)keywords,
-            (PyTypeObject *)ndarray_type, &py_arg_ndarray, &PyBool_Type,
-            &py_arg_deinterleave, &arg_permute))
-        return NULL;
+    Py_BEGIN_ALLOW_THREADS
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->condition.wait(lock, [&]() { return state->done_slot == slot; });
+    Py_END_ALLOW_THREADS
+    state->running_slot = -1;
 
-    py_arg_deinterleave = py_arg_deinterleave == NULL
-                              ? py_arg_deinterleave_default
-                              : py_arg_deinterleave;
+    return slot;
+}
 
-    Py_XINCREF(py_arg_ndarray);
-    Py_XINCREF(py_arg_deinterleave);
+/* Convert a frame into a slot image, reusing its buffer if the frame size
+ * did not change. A frame is a GmicImage (copied), or a (height, width) or
+ * (height, width, channels) C-contiguous float32 or uint8 buffer, such as a
+ * numpy.ndarray. Other objects (eg. PIL images) go through numpy.asarray().
+ * Returns false with a Python exception set on failure. */
+static bool
+gmicpy_stream_load_frame(PyObject *frame, gmic_image<T> &image)
+{
+    Py_buffer view;
+    PyObject *array = NULL;
+    unsigned int width, height, spectrum;
+
+    if (Py_TYPE(frame) == &PyGmicImageType) {
+        gmic_image<T> *source = ((PyGmicImage *)frame)->_gmic_image;
+        image.assign(source->_width, source->_height, source->_depth,
+                     source->_spectrum);
+        memcpy(image._data, source->_data, source->size() * sizeof(T));
+        return true;
+    }
 
-    // Get number of dimensions and ensure we are >=1D <=4D
-    ndarray_ndim = (unsigned int)PyLong_AsSize_t(
-        PyObject_GetAttrString(py_arg_ndarray, "ndim"));
-    if (ndarray_ndim < 1 || ndarray_ndim > 4) {
-        PyErr_Format(GmicException,
-                     "Provided 'data' of type 'numpy.ndarray' must be between "
-                     "1D and 4D ('data.ndim'=%d).",
-                     ndarray_ndim);
-        return NULL;
+    if (!PyObject_CheckBuffer(frame)) {
+#ifdef gmic_py_numpy
+        PyObject *numpy_module = import_numpy_module();
+        if (numpy_module == NULL) {
+            return false;
+        }
+        array = PyObject_CallMethod(numpy_module, "asarray", "O", frame);
+        Py_DECREF(numpy_module);
+        if (array == NULL) {
+            return false;
+        }
+        frame = array;
+#else
+        PyErr_Format(PyExc_TypeError,
+                     "'%.50s' frame is neither a '%.400s' nor a buffer.",
+                     Py_TYPE(frame)->tp_name, PyGmicImageType.tp_name);
+        return false;
+#endif
     }
 
-    // Get input ndarray.dtype and prevent non-integer/float/bool data
-    // types to be processed
-    ndarray_dtype = PyObject_GetAttrString(py_arg_ndarray, "dtype");
-    // Ensure dtype kind is a number we can convert (from dtype values
-    // here:
-    // https://numpy.org/doc/1.18/reference/generated/numpy.dtype.kind.html#numpy.dtype.kind)
-    ndarray_dtype_kind = PyObject_GetAttrString(ndarray_dtype, "kind");
-    if (strchr("biuf", (PyUnicode_ReadChar(ndarray_dtype_kind,
-                                           (Py_ssize_t)0))) == NULL) {
+    if (PyObject_GetBuffer(frame, &view, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) <
+        0) {
+        Py_XDECREF(array);
+        return false;
+    }
+    if ((view.ndim != 2 && view.ndim != 3) || view.format == NULL ||
+        (strcmp(view.format, "f") != 0 && strcmp(view.format, "B") != 0)) {
         PyErr_Format(PyExc_TypeError,
-                     "Parameter 'data' of type 'numpy.ndarray' does not "
-                     "contain numbers ie. its 'dtype.kind'(=%U) is not one of "
-                     "'b', 'i', 'u', 'f'.",
-                     ndarray_dtype_kind);
-        // TODO pytest this
-        return NULL;
+                     "'%.50s' frame must be a 2D or 3D float32 or uint8 "
+                     "buffer, got %dD items of format '%s'.",
+                     Py_TYPE(frame)->tp_name, view.ndim,
+                     view.format != NULL ? view.format : "B");
+        PyBuffer_Release(&view);
+        Py_XDECREF(array);
+        return false;
     }
 
-    // Using an 'ndarray.astype' array casting operation first into
-    // G'MIC's core point type T <=> float32 With a
-    // memory-efficient-'ndarray.view' instead of copy-obligatory
-    // 'ndarray.astype' conversion, we might get the following error:
-    // ValueError: When changing to a larger dtype, its size must be a
-    // divisor of the total size in bytes of the last axis of the
-    // array. So, using 'astype' is the most stable, less
-    // memory-efficient way
-    // :-) :-/
-    float32_ndarray =
-        PyObject_CallMethod(py_arg_ndarray, "astype", "O",
-                            PyObject_GetAttrString(numpy_module, "float32"));
+    height = (unsigned int)view.shape[0];
+    width = (unsigned int)view.shape[1];
+    spectrum = view.ndim == 3 ? (unsigned int)view.shape[2] : 1;
+    image.assign(width, height, 1, spectrum);
+    // Deinterleave pixels, as GmicImage.from_numpy() does
+    if (view.format[0] == 'f') {
+        gmicpy_deinterleave((const float *)view.buf, image._data,
+                            (size_t)width * height, spectrum);
+    }
+    else {
+        gmicpy_deinterleave((const unsigned char *)view.buf, image._data,
+                            (size_t)width * height, spectrum);
+    }
+    PyBuffer_Release(&view);
+    Py_XDECREF(array);
 
-    // Get unsqueezed shape of numpy array -> GmicImage width, height,
-    // depth, spectrum Getting a shape with the most axes from array:
-    // https://docs.scipy.org/doc/numpy-1.17.0/reference/generated/numpy.atleast_3d.html#numpy.atleast_3d
-    // Adding a depth axis using numpy.expand_dims:
-    // https://docs.scipy.org/doc/numpy-1.17.0/reference/generated/numpy.expand_dims.html
-    // (numpy tends to squeeze dimensions when calling the standard
-    // array().shape, we circumvent this)
-    ndarray_as_3d_unsqueezed_view =
-        PyObject_CallMethod(numpy_module, "atleast_3d", "O", float32_ndarray);
-    ndarray_as_3d_unsqueezed_view_expanded_dims = PyObject_CallMethod(
-        numpy_module, "expand_dims", "OI", ndarray_as_3d_unsqueezed_view,
-        2);  // Adding z axis if absent
-    // After this the shape should be (w, h, 1, 3)
-    ndarray_shape_tuple = PyObject_GetAttrString(
-        ndarray_as_3d_unsqueezed_view_expanded_dims, "shape");
-    _height =
-        (unsigned int)PyLong_AsSize_t(PyTuple_GetItem(ndarray_shape_tuple, 0));
-    _width =
-        (unsigned int)PyLong_AsSize_t(PyTuple_GetItem(ndarray_shape_tuple, 1));
-    _depth =
-        (unsigned int)PyLong_AsSize_t(PyTuple_GetItem(ndarray_shape_tuple, 2));
-    _spectrum =
-        (unsigned int)PyLong_AsSize_t(PyTuple_GetItem(ndarray_shape_tuple, 3));
+    return true;
+}
 
-    py_gmicimage_to_fill = (PyGmicImage *)PyObject_CallFunction(
-        (PyObject *)&PyGmicImageType, (const char *)"OIIII",
-        Py_None,  // This empty _data buffer will be regenerated by the
-                  // GmicImage constructor as a zero-filled bytes
-                  // object
-        _width, _height, _depth, _spectrum);
-
-    ndarray_data_bytesObj =
-        PyObject_CallMethod(ndarray_as_3d_unsqueezed_view, "tobytes", NULL);
-    ndarray_data_bytesObj_ptr = (T *)PyBytes_AsString(ndarray_data_bytesObj);
-
-    // no deinterleaving
-    if (!PyObject_IsTrue(py_arg_deinterleave)) {
-        for (unsigned int c = 0; c < _spectrum; c++) {
-            for (unsigned int z = 0; z < _depth; z++) {
-                for (unsigned int y = 0; y < _height; y++) {
-                    for (unsigned int x = 0; x < _width; x++) {
-                        (*(py_gmicimage_to_fill->_gmic_image))(x, y, z, c) =
-                            *(ndarray_data_bytesObj_ptr++);
-                    }
-                }
-            }
-        }
+/* Pull the next frame into a slot. Returns 1 if a frame was loaded, 0 once
+ * frames are exhausted, or -1 with a Python exception set. */
+static int
+PyGmicStream_load_next_frame(PyGmicStream *self, int slot)
+{
+    gmicpy_stream_state *state = self->_state;
+    PyObject *frame = PyIter_Next(self->_frames);
+    bool is_loaded = false;
+
+    if (frame == NULL) {
+        return PyErr_Occurred() ? -1 : 0;
     }
-    else {  // deinterleaving
-        for (unsigned int z = 0; z < _depth; z++) {
-            for (unsigned int y = 0; y < _height; y++) {
-                for (unsigned int x = 0; x < _width; x++) {
-                    for (unsigned int c = 0; c < _spectrum; c++) {
-                        (*(py_gmicimage_to_fill->_gmic_image))(x, y, z, c) =
-                            *(ndarray_data_bytesObj_ptr++);
-                    }
-                }
-            }
+    try {
+        gmic_list<T> &images = state->images[slot];
+        state->image_names[slot].assign();
+        // The list is only resized when its size changes, since assign()
+        // would reallocate it, freeing the first image's buffer that a
+        // former result handed back for this frame. Other former results
+        // are not inputs of the next run.
+        if (images.size() > 1) {
+            images.remove(1, images.size() - 1);
+        }
+        else if (images.size() == 0) {
+            images.insert(1);
         }
+        is_loaded = gmicpy_stream_load_frame(frame, images[0]);
     }
+    catch (std::exception &e) {
+        PyErr_SetString(GmicException, e.what());
+    }
+    Py_DECREF(frame);
 
-    Py_XDECREF(py_arg_ndarray);
-    Py_XDECREF(py_arg_deinterleave);
-    Py_XDECREF(ndarray_dtype);
-    Py_XDECREF(ndarray_dtype_kind);
-    Py_XDECREF(float32_ndarray);
-    Py_XDECREF(ndarray_as_3d_unsqueezed_view);
-    Py_XDECREF(ndarray_as_3d_unsqueezed_view_expanded_dims);
-    Py_XDECREF(ndarray_shape_tuple);
-    Py_XDECREF(ndarray_data_bytesObj);
-    Py_XDECREF(ndarray_type);
-    Py_XDECREF(numpy_module);
-
-    return (PyObject *)py_gmicimage_to_fill;
+    return is_loaded ? 1 : -1;
 }
 
+/* Hand a slot's resulting images over to Python without copies. */
 static PyObject *
-PyGmicImage_from_numpy(PyObject *cls, PyObject *args, PyObject *kwargs)
+PyGmicStream_take_outputs(PyGmicStream *self, int slot)
 {
-    char const *keywords[] = {"numpy_array", NULL};
-    PyObject *arg_np_array = NULL;  // No defaults
-    PyObject *a = NULL;
-    PyObject *kw = NULL;
+    gmic_list<T> &images = self->_state->images[slot];
+    PyObject *outputs = self->_reuse_output ? self->_outputs : NULL;
+    PyObject *image = NULL;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", (char **)keywords,
-                                     &arg_np_array)) {
-        return NULL;
+    if (outputs == NULL) {
+        if (!(outputs = PyList_New(0))) {
+            return NULL;
+        }
+        if (self->_reuse_output) {
+            self->_outputs = outputs;
+        }
+    }
+    if (self->_reuse_output) {
+        Py_INCREF(outputs);
     }
-    a = PyTuple_New(0);
-    kw = PyDict_New();
-    PyDict_SetItemString(kw, "numpy_array", arg_np_array);
-    PyDict_SetItemString(kw, "deinterleave", Py_True);
 
-    Py_DECREF(arg_np_array);
+    cimglist_for(images, l)
+    {
+        image = l < PyList_GET_SIZE(outputs) ? PyList_GET_ITEM(outputs, l)
+                                               : NULL;
+        if (image != NULL && Py_TYPE(image) == &PyGmicImageType &&
+            ((PyGmicImage *)image)->_exports == 0 &&
+            ((PyGmicImage *)image)->_owner_buffer.obj == NULL) {
+            // The former result buffer goes back into the slot, to be
+            // reused by a next frame
+            images[l].swap(*((PyGmicImage *)image)->_gmic_image);
+            continue;
+        }
+        if (!(image = new_gmic_image_from_gmic_list_item(images, l))) {
+            Py_DECREF(outputs);
+            return NULL;
+        }
+        // Exported (or user-replaced) former results are replaced rather
+        // than changed
+        if (l < PyList_GET_SIZE(outputs)) {
+            PyList_SetItem(outputs, l, image);  // Steals image
+            continue;
+        }
+        if (PyList_Append(outputs, image) < 0) {
+            Py_DECREF(image);
+            Py_DECREF(outputs);
+            return NULL;
+        }
+        Py_DECREF(image);
+    }
+    if (PyList_GET_SIZE(outputs) > (Py_ssize_t)images.size() &&
+        PyList_SetSlice(outputs, images.size(), PyList_GET_SIZE(outputs),
+                        NULL) < 0) {
+        Py_DECREF(outputs);
+        return NULL;
+    }
 
-    return PyObject_Call(PyObject_GetAttrString(cls, "from_numpy_helper"), a,
-                         kw);
+    return outputs;
 }
 
 static PyObject *
-PyGmicImage_to_numpy(PyObject *self, PyObject *args, PyObject *kwargs)
+PyGmicStream_next(PyGmicStream *self)
 {
-    PyObject *a = NULL;
-    PyObject *kw = NULL;
+    gmicpy_stream_state *state = self->_state;
+    int loaded = 0;
+    int slot = 0;
+
+    if (self->_error_type != NULL) {
+        // Raise the frame conversion error deferred by the former call
+        PyErr_Restore(self->_error_type, self->_error_value,
+                      self->_error_traceback);
+        self->_error_type = NULL;
+        self->_error_value = NULL;
+        self->_error_traceback = NULL;
+        return NULL;
+    }
 
-    a = PyTuple_New(0);
-    kw = PyDict_New();
-    PyDict_SetItemString(kw, "interleave", Py_True);
+    if (!state->is_started) {
+        state->is_started = true;
+        if ((loaded = PyGmicStream_load_next_frame(self, 0)) <= 0) {
+            return NULL;
+        }
+        try {
+            state->worker =
+                std::thread(gmicpy_stream_work, self->_interpreter, state);
+        }
+        catch (std::exception &e) {
+            PyErr_SetString(GmicException, e.what());
+            return NULL;
+        }
+        gmicpy_stream_submit(state, 0);
+    }
 
-    return PyObject_Call(PyObject_GetAttrString(self, "to_numpy_helper"), a,
-                         kw);
-}
+    if (state->running_slot < 0) {
+        return NULL;  // StopIteration
+    }
 
-static PyObject *
-PyGmicImage_from_skimage(PyObject *cls, PyObject *args, PyObject *kwargs)
-{
-    char const *keywords[] = {"scikit_image", NULL};
-    PyObject *py_permute_str = NULL;
-    PyObject *arg_scikit_image = NULL;  // No defaults
-    PyObject *a = NULL;
-    PyObject *kw = NULL;
+    // Convert the next frame while G'MIC processes the current one
+    loaded = PyGmicStream_load_next_frame(self, 1 - state->running_slot);
+    if (loaded < 0) {
+        PyErr_Fetch(&self->_error_type, &self->_error_value,
+                    &self->_error_traceback);
+    }
+    slot = gmicpy_stream_wait(state);
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O", (char **)keywords,
-                                     &arg_scikit_image)) {
+    if (state->statuses[slot] != GMICPY_RUN_DONE) {
+        // Stop streaming on the first failing frame
+        gmicpy_set_run_error(state->statuses[slot], state->reports[slot]);
         return NULL;
     }
-    a = PyTuple_New(0);
-    kw = PyDict_New();
-    PyDict_SetItemString(kw, "numpy_array", arg_scikit_image);
-    PyDict_SetItemString(kw, "deinterleave", Py_True);
-    py_permute_str = PyUnicode_FromString("zyxc");
-    PyDict_SetItemString(kw, "permute", py_permute_str);
+    if (loaded > 0) {
+        gmicpy_stream_submit(state, 1 - slot);
+    }
 
-    return PyObject_Call(PyObject_GetAttrString(cls, "from_numpy_helper"), a,
-                         kw);
+    return PyGmicStream_take_outputs(self, slot);
 }
 
-static PyObject *
-PyGmicImage_to_skimage(PyObject *self, PyObject *args, PyObject *kwargs)
+static void
+PyGmicStream_dealloc(PyGmicStream *self)
 {
-    PyObject *a = NULL;
-    PyObject *kw = NULL;
-    PyObject *py_permute_str = NULL;
+    gmicpy_stream_state *state = self->_state;
 
-    a = PyTuple_New(0);
-    kw = PyDict_New();
-    PyDict_SetItemString(kw, "interleave", Py_True);
-    py_permute_str = PyUnicode_FromString("zyxc");
-    PyDict_SetItemString(kw, "permute", py_permute_str);
+    if (state != NULL && state->worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->is_quitting = true;
+        }
+        state->condition.notify_all();
+        // A frame may still be processed
+        Py_BEGIN_ALLOW_THREADS
+        state->worker.join();
+        Py_END_ALLOW_THREADS
+    }
+    delete state;
+    self->_state = NULL;
+    Py_XDECREF(self->_interpreter);
+    Py_XDECREF(self->_frames);
+    Py_XDECREF(self->_outputs);
+    Py_XDECREF(self->_error_type);
+    Py_XDECREF(self->_error_value);
+    Py_XDECREF(self->_error_traceback);
+    Py_TYPE(self)->tp_free((PyObject *)self);
+}
 
-    return PyObject_Call(PyObject_GetAttrString(self, "to_numpy_helper"), a,
-                         kw);
+static PyObject *
+PyGmicStream_repr(PyGmicStream *self)
+{
+    return PyUnicode_FromFormat("<%s object at %p with command '%s'>",
+                                Py_TYPE(self)->tp_name, self,
+                                self->_state->command.c_str());
 }
 
+PyDoc_STRVAR(PyGmicStream_doc,
+             "Iterator of G'MIC results over a stream of frames, made by ``Gmic.stream()``.");
+
 static PyObject *
-PyGmicImage_from_PIL(PyObject *cls, PyObject *args, PyObject *kwargs)
+PyGmic_stream(PyGmic *self, PyObject *args, PyObject *kwargs)
 {
-    PyObject *numpy_mod = NULL;
-    PyObject *numpy_intermediate_array = NULL;
-    char const *keywords[] = {"pil_image", NULL};
-    PyObject *PIL_Image_mod = NULL;
-    PyObject *PIL_Image_Image_class = NULL;
-    PyObject *py_permute_str = NULL;
-    PyObject *arg_PIL_image = NULL;  // No defaults
-    PyObject *a = NULL;
-    PyObject *kw = NULL;
+    char const *keywords[] = {"command", "frames", "reuse_output", NULL};
+    char *commands_line = NULL;
+    PyObject *input_frames = NULL;
+    int reuse_output = 0;
+    PyGmicStream *stream = NULL;
 
-    if (!(numpy_mod = import_numpy_module())) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "sO|p", (char **)keywords,
+                                     &commands_line, &input_frames,
+                                     &reuse_output)) {
         return NULL;
     }
 
-    if (!(PIL_Image_mod = PyImport_ImportModule("PIL.Image"))) {
+    stream = (PyGmicStream *)PyGmicStreamType.tp_alloc(&PyGmicStreamType, 0);
+    if (stream == NULL) {
         return NULL;
     }
-
-    PIL_Image_Image_class = PyObject_GetAttrString(PIL_Image_mod, "Image");
-
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!", (char **)keywords,
-                                     (PyTypeObject *)PIL_Image_Image_class,
-                                     &arg_PIL_image)) {
+    stream->_reuse_output = reuse_output;
+    if (!(stream->_frames = PyObject_GetIter(input_frames))) {
+        Py_DECREF(stream);
         return NULL;
     }
-    numpy_intermediate_array = PyObject_CallFunction(
-        PyObject_GetAttrString(numpy_mod, "array"), "O", arg_PIL_image);
-    if (!numpy_intermediate_array) {
+    Py_INCREF(self);
+    stream->_interpreter = self;
+    try {
+        stream->_state = new gmicpy_stream_state();
+    }
+    catch (std::exception &e) {
+        Py_DECREF(stream);
+        PyErr_SetString(GmicException, e.what());
         return NULL;
     }
-    a = PyTuple_New(0);
-    kw = PyDict_New();
-    PyDict_SetItemString(kw, "numpy_array", numpy_intermediate_array);
-    PyDict_SetItemString(kw, "deinterleave", Py_True);
-    py_permute_str = PyUnicode_FromString("zyxc");
-    PyDict_SetItemString(kw, "permute", py_permute_str);
+    stream->_state->command = commands_line;
+    stream->_state->options.max_memory = self->_max_memory;
 
-    Py_DECREF(PIL_Image_Image_class);
-    Py_DECREF(numpy_intermediate_array);
-    Py_DECREF(PIL_Image_mod);
-    Py_DECREF(numpy_mod);
+    return (PyObject *)stream;
+}
 
-    return PyObject_Call(PyObject_GetAttrString(cls, "from_numpy_helper"), a,
-                         kw);
+//------- G'MIC IMAGES SESSION BINDING ----------//
+
+/* Take a session's lock, waiting for it without the GIL held, so that a run
+ * of the session on another thread can take the GIL meanwhile (eg. for its
+ * progress callback). */
+static void
+gmicpy_session_lock(PyGmicSession *self)
+{
+    if (!PyThread_acquire_lock(self->_lock, NOWAIT_LOCK)) {
+        Py_BEGIN_ALLOW_THREADS
+        PyThread_acquire_lock(self->_lock, WAIT_LOCK);
+        Py_END_ALLOW_THREADS
+    }
+}
+
+/* Resolve a possibly negative position among a session's images. Returns
+ * false with an IndexError set if out of range. */
+static bool
+gmicpy_session_position(PyGmicSession *self, Py_ssize_t *position)
+{
+    Py_ssize_t images_count = (Py_ssize_t)self->_images->size();
+
+    if (*position < 0) {
+        *position += images_count;
+    }
+    if (*position < 0 || *position >= images_count) {
+        PyErr_Format(PyExc_IndexError,
+                     "GmicSession image position out of range (%d images).",
+                     (int)images_count);
+        return false;
+    }
+
+    return true;
+}
+
+/* Append a copy of a GmicImage and its name (or an empty one) to a
+ * session's images. */
+static void
+gmicpy_session_push(PyGmicSession *self, PyGmicImage *image,
+                    const char *name)
+{
+    self->_images->insert(1);
+    self->_images->back().assign(*image->_gmic_image, false);
+    // Names are kept as many as images
+    self->_image_names->insert(1);
+    self->_image_names->back().assign(strlen(name) + 1);
+    memcpy(self->_image_names->back()._data, name, strlen(name) + 1);
+}
+
+static void
+PyGmicSession_dealloc(PyGmicSession *self)
+{
+    delete self->_images;
+    self->_images = NULL;
+    delete self->_image_names;
+    self->_image_names = NULL;
+    if (self->_lock != NULL) {
+        PyThread_free_lock(self->_lock);
+        self->_lock = NULL;
+    }
+    Py_XDECREF(self->_interpreter);
+    Py_TYPE(self)->tp_free((PyObject *)self);
 }
 
 static PyObject *
-PyGmicImage_to_PIL(PyObject *self, PyObject *args, PyObject *kwargs)
+PyGmicSession_repr(PyGmicSession *self)
 {
-    PyObject *gmic_mod = NULL;
-    PyObject *numpy_mod = NULL;
-    PyObject *PIL_Image_mod = NULL;
-    PyObject *a = NULL;
-    PyObject *kw = NULL;
-    PyObject *py_permute_str = NULL;
-    PyObject *prePIL_np_array = NULL;
-    char const *keywords[] = {"astype", "squeeze_shape", "mode", NULL};
-    PyObject *arg_astype = NULL;         // defaults to numpy.uint8
-    unsigned int arg_squeeze_shape = 1;  // Defaults to true
-    PyObject *arg_mode = NULL;           // Defaults to 'RGB'
+    return PyUnicode_FromFormat("<%s object at %p with %d images>",
+                                Py_TYPE(self)->tp_name, self,
+                                (int)self->_images->size());
+}
+
+static Py_ssize_t
+PyGmicSession_length(PyGmicSession *self)
+{
+    return (Py_ssize_t)self->_images->size();
+}
 
-    if (!(gmic_mod = PyImport_ImportModule("gmic"))) {
-        return NULL;
-    }
+PyDoc_STRVAR(PyGmicSession_run_doc,
+             "GmicSession.run(command, *, timeout=0, progress=None, max_memory=None)\n\n\
+Run G'MIC commands on the session's resident images, which stay in G'MIC's own memory without any conversion to or from Python.\n\n\
+Args:\n\
+    command (str): An image-processing command in the G'MIC language.\n\
+    timeout (Optional[float]): See ``Gmic.run()``.\n\
+    progress (Optional[Union[Callable[[float], None], numpy.ndarray]]): See ``Gmic.run()``.\n\
+    max_memory (Optional[int]): See ``Gmic.run()``.\n\
+\n\
+Raises:\n\
+    GmicException: If G'MIC fails. The session then holds whatever images G'MIC left.\n\
+    GmicAborted: If the run is stopped by ``Gmic.abort()`` or its ``timeout``.");
 
-    if (!(numpy_mod = import_numpy_module())) {
+static PyObject *
+PyGmicSession_run(PyGmicSession *self, PyObject *args, PyObject *kwargs)
+{
+    char const *keywords[] = {"command", "timeout", "progress", "max_memory",
+                              NULL};
+    char *commands_line = NULL;
+    PyObject *input_progress = NULL;
+    PyObject *input_max_memory = NULL;
+    gmicpy_run_options options;
+    gmicpy_run_report report;
+    bool has_run_failed = false;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "s|$dOO",
+                                     (char **)keywords, &commands_line,
+                                     &options.timeout, &input_progress,
+                                     &input_max_memory)) {
         return NULL;
     }
-
-    if (!(PIL_Image_mod = PyImport_ImportModule("PIL.Image"))) {
+    if (!gmicpy_parse_max_memory(input_max_memory,
+                                 self->_interpreter->_max_memory,
+                                 &options.max_memory) ||
+        !gmicpy_run_options_set_progress(&options, input_progress)) {
         return NULL;
     }
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|O!pO", (char **)keywords,
-                                     &PyType_Type, &arg_astype,
-                                     &arg_squeeze_shape, &arg_mode)) {
-        return NULL;
+    gmicpy_session_lock(self);
+    try {
+        has_run_failed = !PyGmic_run_without_gil(
+            self->_interpreter, commands_line, *self->_images,
+            *self->_image_names, options, report);
     }
-
-    if (arg_astype == NULL) {
-        arg_astype = PyObject_GetAttrString(numpy_mod, "uint8");
+    catch (std::exception &e) {
+        PyErr_SetString(GmicException, e.what());
+        has_run_failed = true;
     }
-
-    if (arg_mode == NULL) {
-        arg_mode = PyUnicode_FromString("RGB");
+    // Commands may add or remove images without names
+    if (self->_image_names->size() > self->_images->size()) {
+        self->_image_names->remove(self->_images->size(),
+                                   self->_image_names->size() - 1);
     }
-
-    a = PyTuple_New(0);
-    kw = PyDict_New();
-    PyDict_SetItemString(kw, "interleave", Py_True);
-    PyDict_SetItemString(kw, "astype", arg_astype);
-    if (arg_squeeze_shape) {
-        PyDict_SetItemString(kw, "squeeze_shape", Py_True);
+    while (self->_image_names->size() < self->_images->size()) {
+        self->_image_names->insert(1);
+        self->_image_names->back().assign(1, 1, 1, 1, 0);
     }
-    py_permute_str = PyUnicode_FromString("zyxc");
-    PyDict_SetItemString(kw, "permute", py_permute_str);
+    PyThread_release_lock(self->_lock);
+    gmicpy_run_options_clear(&options);
 
-    prePIL_np_array =
-        PyObject_Call(PyObject_GetAttrString(self, "to_numpy_helper"), a, kw);
-
-    if (!prePIL_np_array) {
+    if (has_run_failed) {
         return NULL;
     }
 
-    Py_DECREF(gmic_mod);
-    Py_DECREF(numpy_mod);
-    Py_DECREF(PIL_Image_mod);
-    Py_DECREF(py_permute_str);
-    Py_DECREF(kw);
-    Py_DECREF(a);
-    Py_XDECREF(arg_astype);
-
-    return PyObject_CallFunction(
-        PyObject_GetAttrString(PIL_Image_mod, "fromarray"), "OO",
-        prePIL_np_array, arg_mode);
+    Py_RETURN_NONE;
 }
 
-// End of ifdef gmic_py_numpy
-#endif
+PyDoc_STRVAR(PyGmicSession_push_doc,
+             "GmicSession.push(image, name=None)\n\n\
+Append a copy of a ``GmicImage`` to the session's resident images.\n\n\
+Args:\n\
+    image (gmic.GmicImage): The image to copy, left untouched.\n\
+    name (Optional[str]): The image's name in G'MIC commands. Defaults to no name.");
 
-/** Instancing of any c++ gmic::gmic G'MIC language interpreter object
- * (Python: gmic.Gmic) **/
-PyObject *
-PyGmic_new(PyTypeObject *subtype, PyObject *args, PyObject *kwargs)
+static PyObject *
+PyGmicSession_push(PyGmicSession *self, PyObject *args, PyObject *kwargs)
 {
-    PyGmic *self = NULL;
-    T null_T = 0;
-
-    self = (PyGmic *)subtype->tp_alloc(subtype, 0);
+    char const *keywords[] = {"image", "name", NULL};
+    PyGmicImage *image = NULL;
+    char *name = (char *)"";
 
-    // Init resources folder.
-    if (!gmic::init_rc()) {
-        PyErr_Format(GmicException,
-                     "Unable to create G'MIC resources folder.");
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O!|z", (char **)keywords,
+                                     &PyGmicImageType, &image, &name)) {
+        return NULL;
     }
 
-    // Load general and user scripts if they exist
-    // Since this project is a library the G'MIC "update" command that
-    // runs an internet download, is never triggered the user should
-    // run it him/herself.
-    self->_gmic->run((const char* const)"m $_path_rc/update$_version.gmic", 0, 0, null_T);
-    self->_gmic->run((const char* const)"m $_path_user", 0, 0, null_T);
-
-    // If parameters are provided, pipe them to our run() method, and
-    // do only exceptions raising without returning anything if things
-    // go well
-    if (args != Py_None && ((args && (int)PyTuple_Size(args) > 0) ||
-                            (kwargs && (int)PyDict_Size(kwargs) > 0))) {
-        if (run_impl((PyObject *)self, args, kwargs) == NULL) {
-            return NULL;
-        }
+    gmicpy_session_lock(self);
+    try {
+        gmicpy_session_push(self, image, name != NULL ? name : "");
     }
+    catch (...) {
+        PyThread_release_lock(self->_lock);
+        return PyErr_NoMemory();
+    }
+    PyThread_release_lock(self->_lock);
 
-    return (PyObject *)self;
+    Py_RETURN_NONE;
 }
 
-PyDoc_STRVAR(run_impl_doc,
-             "Gmic.run(command, images=None, image_names=None)\n\
-Run G'MIC interpreter following a G'MIC language command(s) string, on 0 or more namable ``GmicImage`` items.\n\n\
-Note (single-image short-hand calling): if ``images`` is a ``GmicImage``, then ``image_names`` must be either a ``str`` or be omitted.\n\n\
-Example:\n\
-    Here is a long example describing several use cases::\n\n\
-        import gmic\n\
-        import struct\n\
-        import random\n\
-        instance1 = gmic.Gmic('echo_stdout \\'instantiation and run all in one\\')\n\
-        instance2 = gmic.Gmic()\n\
-        instance2.run('echo_stdout \\'hello world\\'') # G'MIC command without images parameter\n\
-        a = gmic.GmicImage(struct.pack(*('256f',) + tuple([random.random() for a in range(256)])), 16, 16) # Build 16x16 greyscale image\n\
-        instance2.run('blur 12,0,1 resize 50%,50%', a) # Blur then resize the image\n\
-        a._width == a._height == 8 # The image is half smaller\n\
-        instance2.run('display', a) # If you have X11 enabled (linux only), show the image in a window\n\
-        image_names = ['img_' + str(i) for i in range(10)] # You can also name your images if you have several (optional)\n\
-        images = [gmic.GmicImage(struct.pack(*((str(w*h)+'f',) + (i*2.0,)*w*h)), w, h) for i in range(10)] # Prepare a list of image\n\
-        instance1.run('add 1 print', images, image_names) # And pipe those into the interpreter\n\
-        instance1.run('blur 10,0,1 print', images[0], 'my_pic_name') # Short-hand 1-image calling style\n\n\
+PyDoc_STRVAR(PyGmicSession_fetch_doc,
+             "GmicSession.fetch(position=-1)\n\n\
+Get a copy of one of the session's resident images, which stays in the session.\n\n\
 Args:\n\
-    command (str): An image-processing command in the G'MIC language\n\
-    images (Optional[Union[List[gmic.GmicImage], gmic.GmicImage]]): A list of ``GmicImage`` items that G'MIC will edit in place, or a single ``gmic.GmicImage`` which will used for input only. Defaults to None.\n\
-        Put a list variable here, not a plain ``[]``.\n\
-        If you pass a list, it can be empty if you intend to fill or complement it using your G'MIC command.\n\
-    image_names (Optional[List<str>]): A list of names for the images, defaults to None.\n\
-        In-place editing by G'MIC can happen, you might want to pass your list as a variable instead.\n\
+    position (Optional[int]): Position of the image, negative ones counting from the end. Defaults to the last image.\n\
 \n\
 Returns:\n\
-    None: Returns ``None`` or raises a ``GmicException``.\n\
+    gmic.GmicImage: A new ``GmicImage`` copied from the session.\n\
 \n\
 Raises:\n\
-    GmicException: This translates' G'MIC C++ same-named exception. Look at the exception message for details.");
-
-static PyMethodDef PyGmic_methods[] = {
-    {"run", (PyCFunction)run_impl, METH_VARARGS | METH_KEYWORDS, run_impl_doc},
-    {NULL} /* Sentinel */
-};
+    IndexError: If there is no image at this position.");
 
-// ------------ G'MIC IMAGE BINDING ----//
-
-PyObject *
-PyGmicImage_new(PyTypeObject *subtype, PyObject *args, PyObject *kwargs)
+static PyObject *
+PyGmicSession_fetch(PyGmicSession *self, PyObject *args, PyObject *kwargs)
 {
-    PyGmicImage *self = NULL;
-    unsigned int _width =
-        1;  // Number of image columns (dimension along the X-axis)
-    unsigned int _height =
-        1;  // Number of image lines (dimension along the Y-axis)
-    unsigned int _depth =
-        1;  // Number of image slices (dimension along the Z-axis)
-    unsigned int _spectrum =
-        1;  // Number of image channels (dimension along the C-axis)
-    Py_ssize_t dimensions_product;  // All integer parameters
-                                    // multiplied together,
-    // will help for allocating (ie. assign()ing)
-    Py_ssize_t _data_bytes_size;
-    int _is_shared = 0;  // Whether image should be shared across gmic
-                         // operations (if true,
-    // operations like resize will fail)
-    PyObject *bytesObj = NULL;  // Incoming bytes buffer object pointer
-
-    bool bytesObj_is_bytes = false;
-    char const *keywords[] = {"data",     "width",  "height", "depth",
-                              "spectrum", "shared", NULL};
-
-    // Parameters parsing and checking
-    if (!PyArg_ParseTupleAndKeywords(
-            args, kwargs, "|OIIIIp", (char **)keywords, &bytesObj, &_width,
-            &_height, &_depth, &_spectrum, &_is_shared))
-        return NULL;
+    char const *keywords[] = {"position", NULL};
+    Py_ssize_t position = -1;
+    PyGmicImage *image = NULL;
 
-    self = (PyGmicImage *)subtype->tp_alloc(subtype, 0);
-    if (self == NULL) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|n", (char **)keywords,
+                                     &position)) {
         return NULL;
     }
-
-    // Default bytesObj value to None
-    if (bytesObj == NULL) {
-        bytesObj = Py_None;
-    }
-    else {
-        Py_INCREF(bytesObj);
-    }
-
-    if (bytesObj != Py_None) {
-        bytesObj_is_bytes = (bool)PyBytes_Check(bytesObj);
-        if (!bytesObj_is_bytes) {
-            PyErr_Format(PyExc_TypeError,
-                         "Parameter 'data' must be a "
-                         "pure-python 'bytes' buffer object.");
-            // TODO pytest this
-            return NULL;
-        }
-    }
-    else {  // if bytesObj is None, attempt to set it as an empty bytes
-            // object
-        // following image dimensions
-        // If dimensions are OK, create a pixels-count-zero-filled
-        // bytesarray-based bytes object to be ingested by the _data
-        // parameter
-        if (_width >= 1 && _height >= 1 && _depth >= 1 && _spectrum >= 1) {
-            bytesObj = PyObject_CallFunction(
-                (PyObject *)&PyBytes_Type, "O",
-                PyObject_CallFunction(
-                    (PyObject *)&PyByteArray_Type, "I",
-                    _width * _height * _depth * _spectrum * sizeof(T), NULL),
-                NULL);
-            Py_INCREF(bytesObj);
-            bytesObj_is_bytes = true;
-            // TODO pytest this
-        }
-        else {  // If dimensions are not OK, raise exception
-            PyErr_Format(PyExc_TypeError,
-                         "If you do not provide a 'data' parameter, make at "
-                         "least all dimensions >=1.");
-            // TODO pytest this
-            return NULL;
-        }
+    image = (PyGmicImage *)PyGmicImageType.tp_alloc(&PyGmicImageType, 0);
+    if (image == NULL) {
+        return NULL;
     }
 
-    // Bytes object spatial dimensions vs. bytes-length checking
-    dimensions_product = _width * _height * _depth * _spectrum;
-    _data_bytes_size = PyBytes_Size(bytesObj);
-    if ((Py_ssize_t)(dimensions_product * sizeof(T)) != _data_bytes_size) {
-        PyErr_Format(PyExc_ValueError,
-                     "GmicImage dimensions-induced buffer bytes size "
-                     "(%d*%dB=%d) cannot be strictly negative or "
-                     "different than the _data buffer size in bytes (%d)",
-                     dimensions_product, sizeof(T),
-                     dimensions_product * sizeof(T), _data_bytes_size);
+    gmicpy_session_lock(self);
+    if (!gmicpy_session_position(self, &position)) {
+        PyThread_release_lock(self->_lock);
+        Py_DECREF(image);
         return NULL;
     }
-
-    // Importing input data to an internal buffer
     try {
-        self->_gmic_image->assign(_width, _height, _depth, _spectrum);
-        self->_gmic_image->_is_shared = _is_shared;
+        image->_gmic_image->assign((*self->_images)[position], false);
     }
-    // Ugly exception catching, probably to catch a
-    // cimg::GmicInstanceException()
     catch (...) {
-        dimensions_product = _width * _height * _depth * _spectrum;
-        PyErr_Format(PyExc_MemoryError,
-                     "Allocation error in "
-                     "GmicImage::assign(_width=%d,_height=%d,_depth=%d,_"
-                     "spectrum=%d), "
-                     "are you requesting too much memory (%d bytes)?",
-                     _width, _height, _depth, _spectrum,
-                     dimensions_product * sizeof(T));
-        return NULL;
+        PyThread_release_lock(self->_lock);
+        Py_DECREF(image);
+        return PyErr_NoMemory();
     }
+    PyThread_release_lock(self->_lock);
 
-    memcpy(self->_gmic_image->_data, PyBytes_AsString(bytesObj),
-           PyBytes_Size(bytesObj));
-
-    Py_XDECREF(bytesObj);
-
-    return (PyObject *)self;
+    return (PyObject *)image;
 }
 
-static PyObject *
-PyGmicImage_repr(PyGmicImage *self)
-{
-    return PyUnicode_FromFormat(
-        "<%s object at %p with _data address at %p, w=%d h=%d d=%d "
-        "s=%d "
-        "shared=%d>",
-        Py_TYPE(self)->tp_name, self, self->_gmic_image->_data,
-        self->_gmic_image->_width, self->_gmic_image->_height,
-        self->_gmic_image->_depth, self->_gmic_image->_spectrum,
-        self->_gmic_image->_is_shared);
-}
+PyDoc_STRVAR(PyGmicSession_pop_doc,
+             "GmicSession.pop(position=-1)\n\n\
+Remove one of the session's resident images and return it, without copying its pixels.\n\n\
+Args:\n\
+    position (Optional[int]): Position of the image, negative ones counting from the end. Defaults to the last image.\n\
+\n\
+Returns:\n\
+    gmic.GmicImage: A new ``GmicImage`` taking over the session's image.\n\
+\n\
+Raises:\n\
+    IndexError: If there is no image at this position.");
 
 static PyObject *
-PyGmicImage_call(PyObject *self, PyObject *args, PyObject *kwargs)
+PyGmicSession_pop(PyGmicSession *self, PyObject *args, PyObject *kwargs)
 {
-    const char *keywords[] = {"x", "y", "z", "s", NULL};
-    int x, y, z, c;
-    x = y = z = c = 0;
+    char const *keywords[] = {"position", NULL};
+    Py_ssize_t position = -1;
+    PyObject *image = NULL;
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|iiii", (char **)keywords,
-                                     &x, &y, &z, &c)) {
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|n", (char **)keywords,
+                                     &position)) {
         return NULL;
     }
 
-    return PyFloat_FromDouble(
-        (*((PyGmicImage *)self)->_gmic_image)(x, y, z, c));
-}
-
-static PyObject *
-PyGmicImage_alloc(PyTypeObject *type, Py_ssize_t nitems)
-{
-    PyObject *obj = (PyObject *)PyObject_Malloc(type->tp_basicsize);
-    ((PyGmicImage *)obj)->_gmic_image = new gmic_image<T>();
-    GMIC_PY_LOG("PyGmicImage_alloc\n");
-    PyObject_Init(obj, type);
-    return obj;
-}
-
-static PyObject *
-PyGmic_alloc(PyTypeObject *type, Py_ssize_t nitems)
-{
-    PyObject *obj = (PyObject *)PyObject_Malloc(type->tp_basicsize);
-    ((PyGmic *)obj)->_gmic = new gmic();
-    GMIC_PY_LOG("PyGmic_alloc\n");
-    PyObject_Init(obj, type);
-    return obj;
-}
-
-static void
-PyGmicImage_free(PyObject *v)
-{
-    PyObject_Free(v);
+    gmicpy_session_lock(self);
+    if (gmicpy_session_position(self, &position)) {
+        image = new_gmic_image_from_gmic_list_item(*self->_images,
+                                                   (int)position);
+    }
+    if (image != NULL) {
+        self->_images->remove((unsigned int)position);
+        self->_image_names->remove((unsigned int)position);
+    }
+    PyThread_release_lock(self->_lock);
+
+    return image;
 }
 
-static void
-PyGmic_free(PyObject *v)
+PyDoc_STRVAR(PyGmicSession_clear_doc,
+             "GmicSession.clear()\n\n\
+Remove all of the session's resident images.");
+
+static PyObject *
+PyGmicSession_clear(PyGmicSession *self, PyObject *args)
 {
-    PyObject_Free(v);
+    gmicpy_session_lock(self);
+    self->_images->assign();
+    self->_image_names->assign();
+    PyThread_release_lock(self->_lock);
+
+    Py_RETURN_NONE;
 }
 
-static void
-PyGmicImage_dealloc(PyGmicImage *self)
+static PyObject *
+PyGmicSession_get_names(PyGmicSession *self, void *closure)
 {
-    delete self->_gmic_image;
-    self->_gmic_image = NULL;
-    GMIC_PY_LOG("PyGmicImage_dealloc\n");
-    Py_TYPE(self)->tp_free((PyObject *)self);
+    PyObject *names = NULL;
+
+    gmicpy_session_lock(self);
+    names = PyList_New(self->_image_names->size());
+    for (unsigned int l = 0; names != NULL && l < self->_image_names->size();
+         l++) {
+        PyList_SET_ITEM(names, l,
+                        PyUnicode_FromString((*self->_image_names)[l]._data));
+    }
+    PyThread_release_lock(self->_lock);
+
+    return names;
 }
 
-static void
-PyGmic_dealloc(PyGmic *self)
+static PyMethodDef PyGmicSession_methods[] = {
+    {"run", (PyCFunction)PyGmicSession_run, METH_VARARGS | METH_KEYWORDS,
+     PyGmicSession_run_doc},
+    {"push", (PyCFunction)PyGmicSession_push, METH_VARARGS | METH_KEYWORDS,
+     PyGmicSession_push_doc},
+    {"fetch", (PyCFunction)PyGmicSession_fetch, METH_VARARGS | METH_KEYWORDS,
+     PyGmicSession_fetch_doc},
+    {"pop", (PyCFunction)PyGmicSession_pop, METH_VARARGS | METH_KEYWORDS,
+     PyGmicSession_pop_doc},
+    {"clear", (PyCFunction)PyGmicSession_clear, METH_NOARGS,
+     PyGmicSession_clear_doc},
+    {NULL} /* Sentinel */
+};
+
+PyGetSetDef PyGmicSession_getsets[] = {
+    {(char *)"names", (getter)PyGmicSession_get_names, NULL,
+     (char *)"Names of the session's resident images, empty for unnamed "
+             "ones.",
+     NULL},
+    {NULL}};
+
+static PySequenceMethods PyGmicSession_as_sequence = {
+    (lenfunc)PyGmicSession_length,  // sq_length
+};
+
+PyDoc_STRVAR(PyGmicSession_doc,
+             "Images resident in G'MIC's own memory across runs, made by ``Gmic.session()``. Use ``len(session)`` for their count.");
+
+static PyObject *
+PyGmic_session(PyGmic *self, PyObject *args, PyObject *kwargs)
 {
-    delete self->_gmic;
-    self->_gmic = NULL;
-    // keep this in place for test_gmic_py_memfreeing.py pytest case
-    GMIC_PY_LOG("PyGmic_dealloc\n");
-    Py_TYPE(self)->tp_free((PyObject *)self);
+    char const *keywords[] = {"images", "image_names", NULL};
+    PyObject *input_gmic_images = NULL;
+    PyObject *input_gmic_image_names = NULL;
+    PyObject *images_sequence = NULL;
+    PyGmicSession *session = NULL;
+    Py_ssize_t images_count = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|OO", (char **)keywords,
+                                     &input_gmic_images,
+                                     &input_gmic_image_names)) {
+        return NULL;
+    }
+    if (input_gmic_images != NULL && input_gmic_images != Py_None) {
+        images_sequence = Py_TYPE(input_gmic_images) == &PyGmicImageType
+                              ? PyTuple_Pack(1, input_gmic_images)
+                              : PySequence_Fast(input_gmic_images,
+                                                "'images' parameter must be "
+                                                "a GmicImage or a sequence "
+                                                "of GmicImages.");
+        if (images_sequence == NULL) {
+            return NULL;
+        }
+        images_count = PySequence_Fast_GET_SIZE(images_sequence);
+    }
+    if (input_gmic_image_names != NULL && input_gmic_image_names != Py_None &&
+        (!PyList_Check(input_gmic_image_names) ||
+         PyList_GET_SIZE(input_gmic_image_names) > images_count)) {
+        PyErr_SetString(PyExc_TypeError,
+                        "'image_names' parameter must be a list of at most "
+                        "as many 'str' as images.");
+        Py_XDECREF(images_sequence);
+        return NULL;
+    }
+    for (Py_ssize_t l = 0; l < images_count; l++) {
+        PyObject *image = PySequence_Fast_GET_ITEM(images_sequence, l);
+        PyObject *name =
+            input_gmic_image_names != NULL &&
+                    input_gmic_image_names != Py_None &&
+                    l < PyList_GET_SIZE(input_gmic_image_names)
+                ? PyList_GET_ITEM(input_gmic_image_names, l)
+                : NULL;
+        if (Py_TYPE(image) != &PyGmicImageType ||
+            (name != NULL && !PyUnicode_Check(name))) {
+            PyErr_Format(PyExc_TypeError,
+                         "'%.50s' input object found at position %d in "
+                         "'images' is not a '%.400s', or its name is not a "
+                         "'str'.",
+                         Py_TYPE(image)->tp_name, (int)l,
+                         PyGmicImageType.tp_name);
+            Py_XDECREF(images_sequence);
+            return NULL;
+        }
+    }
+
+    session =
+        (PyGmicSession *)PyGmicSessionType.tp_alloc(&PyGmicSessionType, 0);
+    if (session == NULL) {
+        Py_XDECREF(images_sequence);
+        return NULL;
+    }
+    Py_INCREF(self);
+    session->_interpreter = self;
+    session->_lock = PyThread_allocate_lock();
+    try {
+        session->_images = new gmic_list<T>();
+        session->_image_names = new gmic_list<char>();
+        for (Py_ssize_t l = 0; l < images_count; l++) {
+            PyObject *name =
+                input_gmic_image_names != NULL &&
+                        input_gmic_image_names != Py_None &&
+                        l < PyList_GET_SIZE(input_gmic_image_names)
+                    ? PyList_GET_ITEM(input_gmic_image_names, l)
+                    : NULL;
+            gmicpy_session_push(
+                session,
+                (PyGmicImage *)PySequence_Fast_GET_ITEM(images_sequence, l),
+                name != NULL ? PyUnicode_AsUTF8(name) : "");
+        }
+    }
+    catch (...) {
+        Py_XDECREF(images_sequence);
+        Py_DECREF(session);
+        return PyErr_NoMemory();
+    }
+    Py_XDECREF(images_sequence);
+    if (session->_lock == NULL) {
+        Py_DECREF(session);
+        return PyErr_NoMemory();
+    }
+
+    return (PyObject *)session;
 }
 
 static PyObject *
@@ -1510,6 +6049,7 @@ Args:\n\
     images (Optional[Union[List[gmic.GmicImage], gmic.GmicImage]]): A list of ``GmicImage`` items that G'MIC will edit in place, or a single ``gmic.GmicImage`` which will used for input only. Defaults to None.\n\
         Put a list variable here, not a plain ``[]``.\n\
         If you pass a list, it can be empty if you intend to fill or complement it using your G'MIC command.\n\
+        Results are written back by position into the list's ``GmicImage`` objects, so that other references to them (eg. variables or ``numpy.asarray()`` views) see the results, and only images added by G'MIC become new objects. Exported buffers get same-sized results copied into them, and are replaced in the list by new objects otherwise.\n\
     image_names (Optional[List<str>]): A list of names for the images, defaults to None.\n\
         In-place editing by G'MIC can happen, you might want to pass your list as a variable instead.\n\
 \n\
@@ -1526,7 +6066,7 @@ static PyMethodDef gmic_methods[] = {
 
 PyDoc_STRVAR(gmic_module_doc,
              "G'MIC image processing library Python binary module.\n\n\
-Use ``gmic.run`` or ``gmic.Gmic`` to run G'MIC commands inside the G'MIC C++ interpreter, manipulate ``gmic.GmicImage`` which has ``numpy``/``PIL`` input/output support, assemble lists of ``gmic.GmicImage`` items inside read-writeable pure-Python `list` objects.\n\n\
+Use ``gmic.run`` or ``gmic.Gmic`` to run G'MIC commands inside the G'MIC C++ interpreter (or ``gmic.GmicPool`` to run them in parallel), manipulate ``gmic.GmicImage`` which has ``numpy``/``PIL`` input/output support, assemble lists of ``gmic.GmicImage`` items inside read-writeable pure-Python `list` objects.\n\n\
 \n\n");
 
 PyModuleDef gmic_module = {PyModuleDef_HEAD_INIT, "gmic", gmic_module_doc, 0,
@@ -1547,7 +6087,9 @@ Example:\n\n\
         # Output: <gmic.GmicImage object at 0x7f09bfb504f8 with _data address at 0x22dd5b0, w=1 h=1 d=1 s=1 shared=0>\n\
         i(0,0) == 1.0 # Using GmicImage(x,y,z) pixel reading operator after initialization\n\
         gmic.run('resize 200%,200%', i) # Some G'MIC operations may reallocate the image buffer in place without risk\n\
-        i._width == i._height == 2 # Use the _width, _height, _depth, _spectrum, _data, _data_str, _is_shared read-only attributes\n\n\
+        i._width == i._height == 2 # Use the _width, _height, _depth, _spectrum, _data, _data_str, _is_shared read-only attributes\n\
+        m = memoryview(i) # Zero-copy writable view of the pixels, m[x,y,z,c] == i(x,y,z,c), also works with numpy.asarray(i)\n\
+        m[0,0,0,0] = 2.0 # Writes into the GmicImage\n\n\
 Args:\n\
     data (Optional[bytes]): Raw data for the image (must be a sequence of 4-bytes floats blocks, with as many blocks as all the dimensions multiplied together).\n\
     width (Optional[int]): Image width in pixels. Defaults to 1.\n\
@@ -1569,7 +6111,524 @@ Note:\n\
             for y in range(image._height):\n\
                 for z in range(image._depth):\n\
                     for c in range(image._spectrum):\n\
-                        print(image(x,y,z,c))");
+                        print(image(x,y,z,c))\n\n\
+    **GmicImage[x, y, z, c]**\n\n\
+    Subscripts of ints or slices (with a step of 1) along up to 4 (x, y, z, c) axes give sub-images, ints keeping their axis with a size of 1. Regions that are contiguous in G'MIC's planar layout, ie. ranges of channels, of slices of a channel, or of lines of a slice and channel, are views sharing this image's pixels, which can be passed to ``run()`` on their own. As with a ``memoryview``, this image cannot change dimensions during runs while views live. Other regions, such as ``image[10:20, 10:20]``, are cropped copies, which can be written back with ``image[10:20, 10:20] = region``. Regions can be filled with a number too::\n\n\
+        red = image[:, :, :, 0] # View of the first channel\n\
+        gmic.run('blur 2', red) # Blurs the first channel of image only\n\
+        region = image[10:20, 10:20] # Copy\n\
+        gmic.run('mirror x', region)\n\
+        image[10:20, 10:20] = region\n\
+        image[0:5, 0:5] = 0");
+
+/* Buffer protocol export of a GmicImage's pixels, without copy. The planar
+ * buffer is seen as a 4D (width, height, depth, spectrum) Fortran-ordered
+ * array, so that view[x, y, z, c] == image(x, y, z, c). */
+static int
+PyGmicImage_getbuffer(PyGmicImage *self, Py_buffer *view, int flags)
+{
+    gmic_image<T> *image = self->_gmic_image;
+    Py_ssize_t *shape_and_strides = NULL;
+    // With at most one dimension above 1, the layout is C-contiguous too
+    bool is_c_contiguous = (image->_width > 1) + (image->_height > 1) +
+                               (image->_depth > 1) + (image->_spectrum > 1) <=
+                           1;
+    bool wants_c_contiguous =
+        (flags & PyBUF_C_CONTIGUOUS) == PyBUF_C_CONTIGUOUS ||
+        ((flags & PyBUF_ND) && (flags & PyBUF_STRIDES) != PyBUF_STRIDES);
+
+    if (wants_c_contiguous && !is_c_contiguous) {
+        PyErr_SetString(PyExc_BufferError,
+                        "GmicImage buffers are Fortran-contiguous "
+                        "(width, height, depth, spectrum) arrays, request "
+                        "strides or Fortran contiguity.");
+        view->obj = NULL;
+        return -1;
+    }
+
+    view->buf = image->_data;
+    view->len = (Py_ssize_t)(image->size() * sizeof(T));
+    view->readonly = 0;
+    view->itemsize = sizeof(T);
+    view->format = NULL;
+    if (flags & PyBUF_FORMAT) {
+        view->format = (char *)(sizeof(T) == sizeof(double) ? "d" : "f");
+    }
+    view->ndim = 1;
+    view->shape = NULL;
+    view->strides = NULL;
+    view->suboffsets = NULL;
+    view->internal = NULL;
+    if (flags & PyBUF_ND) {
+        shape_and_strides = (Py_ssize_t *)PyMem_Malloc(8 * sizeof(Py_ssize_t));
+        if (shape_and_strides == NULL) {
+            PyErr_NoMemory();
+            view->obj = NULL;
+            return -1;
+        }
+        shape_and_strides[0] = image->_width;
+        shape_and_strides[1] = image->_height;
+        shape_and_strides[2] = image->_depth;
+        shape_and_strides[3] = image->_spectrum;
+        shape_and_strides[4] = sizeof(T);
+        shape_and_strides[5] = shape_and_strides[4] * image->_width;
+        shape_and_strides[6] = shape_and_strides[5] * image->_height;
+        shape_and_strides[7] = shape_and_strides[6] * image->_depth;
+        view->ndim = 4;
+        view->shape = shape_and_strides;
+        if ((flags & PyBUF_STRIDES) == PyBUF_STRIDES) {
+            view->strides = shape_and_strides + 4;
+        }
+        view->internal = shape_and_strides;
+    }
+    view->obj = (PyObject *)self;
+    Py_INCREF(self);
+    self->_exports++;
+
+    return 0;
+}
+
+static void
+PyGmicImage_releasebuffer(PyGmicImage *self, Py_buffer *view)
+{
+    PyMem_Free(view->internal);
+    self->_exports--;
+}
+
+static PyBufferProcs PyGmicImage_as_buffer = {
+    (getbufferproc)PyGmicImage_getbuffer,
+    (releasebufferproc)PyGmicImage_releasebuffer,
+};
+
+//------- DLPACK TENSORS EXCHANGE ----------//
+
+/* Subset of the DLPack ABI (https://dmlc.github.io/dlpack/latest/), with
+ * the same layout as dlpack.h's unversioned DLManagedTensor, exchanged
+ * through "dltensor" PyCapsules by __dlpack__() and from_dlpack() array
+ * library functions. */
+enum gmicpy_dl_device_type { GMICPY_DL_CPU = 1 };
+
+enum gmicpy_dl_data_type_code {
+    GMICPY_DL_INT = 0,
+    GMICPY_DL_UINT = 1,
+    GMICPY_DL_FLOAT = 2,
+    GMICPY_DL_BOOL = 6
+};
+
+typedef struct {
+    int32_t device_type;
+    int32_t device_id;
+} gmicpy_dl_device;
+
+typedef struct {
+    uint8_t code;
+    uint8_t bits;
+    uint16_t lanes;
+} gmicpy_dl_data_type;
+
+typedef struct {
+    void *data;
+    gmicpy_dl_device device;
+    int32_t ndim;
+    gmicpy_dl_data_type dtype;
+    int64_t *shape;
+    int64_t *strides;  // In items, or NULL for a compact C-ordered tensor
+    uint64_t byte_offset;
+} gmicpy_dl_tensor;
+
+typedef struct gmicpy_dl_managed_tensor {
+    gmicpy_dl_tensor dl_tensor;
+    void *manager_ctx;
+    void (*deleter)(struct gmicpy_dl_managed_tensor *self);
+} gmicpy_dl_managed_tensor;
+
+/* A GmicImage's pixels exported as a (width, height, depth, spectrum)
+ * Fortran-ordered tensor, as with the buffer protocol. The tensor holds a
+ * reference and a buffer export on the GmicImage until its consumer calls
+ * the deleter. */
+struct gmicpy_dlpack_export {
+    gmicpy_dl_managed_tensor managed_tensor;
+    int64_t shape[4];
+    int64_t strides[4];
+};
+
+/* Deleter of exported tensors, which consumers may call from any thread. */
+static void
+gmicpy_dlpack_export_deleter(gmicpy_dl_managed_tensor *managed_tensor)
+{
+    PyGILState_STATE gil_state = PyGILState_Ensure();
+    PyGmicImage *image = (PyGmicImage *)managed_tensor->manager_ctx;
+
+    image->_exports--;
+    Py_DECREF(image);
+    PyMem_RawFree(managed_tensor);
+    PyGILState_Release(gil_state);
+}
+
+/* Destructor of "dltensor" capsules, which deletes their tensor unless a
+ * consumer renamed the capsule to "used_dltensor" when taking it over. */
+static void
+gmicpy_dlpack_capsule_destructor(PyObject *capsule)
+{
+    gmicpy_dl_managed_tensor *managed_tensor = NULL;
+    PyObject *error_type = NULL;
+    PyObject *error_value = NULL;
+    PyObject *error_traceback = NULL;
+
+    if (PyCapsule_IsValid(capsule, "used_dltensor")) {
+        return;
+    }
+    PyErr_Fetch(&error_type, &error_value, &error_traceback);
+    managed_tensor = (gmicpy_dl_managed_tensor *)PyCapsule_GetPointer(
+        capsule, "dltensor");
+    if (managed_tensor == NULL) {
+        PyErr_WriteUnraisable(capsule);
+    }
+    else if (managed_tensor->deleter != NULL) {
+        managed_tensor->deleter(managed_tensor);
+    }
+    PyErr_Restore(error_type, error_value, error_traceback);
+}
+
+/* Destructor of the capsules through which GmicImages sharing a consumed
+ * tensor's pixels own it (see GmicImage._owner_buffer). */
+static void
+gmicpy_dlpack_owner_destructor(PyObject *capsule)
+{
+    gmicpy_dl_managed_tensor *managed_tensor =
+        (gmicpy_dl_managed_tensor *)PyCapsule_GetPointer(
+            capsule, "gmic.dltensor_owner");
+
+    if (managed_tensor != NULL && managed_tensor->deleter != NULL) {
+        managed_tensor->deleter(managed_tensor);
+    }
+}
+
+/* Python buffer format of a DLPack item type, or 0 if G'MIC cannot read it.
+ */
+static char
+gmicpy_dlpack_format(gmicpy_dl_data_type dtype)
+{
+    if (dtype.lanes != 1) {
+        return 0;
+    }
+    switch (dtype.code) {
+        case GMICPY_DL_BOOL:
+            return dtype.bits == 8 ? '?' : 0;
+        case GMICPY_DL_INT:
+            return dtype.bits == 8    ? 'b'
+                   : dtype.bits == 16 ? 'h'
+                   : dtype.bits == 32 ? 'i'
+                                      : 0;
+        case GMICPY_DL_UINT:
+            return dtype.bits == 8    ? 'B'
+                   : dtype.bits == 16 ? 'H'
+                   : dtype.bits == 32 ? 'I'
+                                      : 0;
+        case GMICPY_DL_FLOAT:
+            return dtype.bits == 32 ? 'f' : dtype.bits == 64 ? 'd' : 0;
+        default:
+            return 0;
+    }
+}
+
+PyDoc_STRVAR(PyGmicImage___dlpack___doc,
+             "GmicImage.__dlpack__(*, stream=None, max_version=None, dl_device=None, copy=None)\n\n\
+Export this image's pixels as a DLPack capsule, for ``numpy.from_dlpack()``, ``torch.from_dlpack()`` and other array libraries.\n\
+The tensor is a 4D (width, height, depth, spectrum) float32 one with Fortran-ordered strides, so that ``tensor[x, y, z, c] == image(x, y, z, c)``, as with ``memoryview(image)``. It shares this image's pixels unless ``copy`` is ``True``, and the image cannot change dimensions during runs while the tensor lives.\n\n\
+Args:\n\
+    stream (Optional[int]): Must be ``None`` or ``-1``, since pixels live on the CPU.\n\
+    max_version (Optional[tuple]): Ignored, an unversioned DLPack capsule is always returned.\n\
+    dl_device (Optional[tuple]): Must be ``None`` or ``(1, 0)`` (CPU).\n\
+    copy (Optional[bool]): If ``True``, export a copy of the pixels.\n\
+\n\
+Returns:\n\
+    PyCapsule: A \"dltensor\" capsule, to be consumed once.\n\
+\n\
+Raises:\n\
+    BufferError: If another device or stream is requested.");
+
+static PyObject *
+PyGmicImage___dlpack__(PyGmicImage *self, PyObject *args, PyObject *kwargs)
+{
+    char const *keywords[] = {"stream", "max_version", "dl_device", "copy",
+                              NULL};
+    PyObject *arg_stream = Py_None;
+    PyObject *arg_max_version = Py_None;
+    PyObject *arg_dl_device = Py_None;
+    PyObject *arg_copy = Py_None;
+    PyObject *cpu_device = NULL;
+    PyGmicImage *image = self;
+    gmicpy_dlpack_export *dlpack_export = NULL;
+    PyObject *capsule = NULL;
+    int is_cpu_device = 0;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|$OOOO",
+                                     (char **)keywords, &arg_stream,
+                                     &arg_max_version, &arg_dl_device,
+                                     &arg_copy)) {
+        return NULL;
+    }
+    if (arg_stream != Py_None &&
+        !(PyLong_Check(arg_stream) && PyLong_AsLong(arg_stream) == -1)) {
+        PyErr_SetString(PyExc_BufferError,
+                        "GmicImage pixels live on the CPU, 'stream' must be "
+                        "None or -1.");
+        return NULL;
+    }
+    if (arg_dl_device != Py_None) {
+        cpu_device = Py_BuildValue("(ii)", GMICPY_DL_CPU, 0);
+        is_cpu_device =
+            PyObject_RichCompareBool(arg_dl_device, cpu_device, Py_EQ);
+        Py_XDECREF(cpu_device);
+        if (is_cpu_device != 1) {
+            PyErr_SetString(PyExc_BufferError,
+                            "GmicImage pixels can only be exported to the "
+                            "CPU 'dl_device' (1, 0).");
+            return NULL;
+        }
+    }
+
+    // Copies are exported through a new GmicImage owning them
+    if (arg_copy != Py_None && PyObject_IsTrue(arg_copy)) {
+        image = (PyGmicImage *)PyGmicImageType.tp_alloc(&PyGmicImageType, 0);
+        if (image == NULL) {
+            return NULL;
+        }
+        try {
+            image->_gmic_image->assign(*self->_gmic_image, false);
+        }
+        catch (...) {
+            PyErr_Format(PyExc_MemoryError,
+                         "Allocation error in GmicImage::assign(_width=%u,_"
+                         "height=%u,_depth=%u,_spectrum=%u), are you "
+                         "requesting too much memory?",
+                         self->_gmic_image->_width,
+                         self->_gmic_image->_height,
+                         self->_gmic_image->_depth,
+                         self->_gmic_image->_spectrum);
+            Py_DECREF(image);
+            return NULL;
+        }
+    }
+    else {
+        Py_INCREF(image);
+    }
+
+    dlpack_export =
+        (gmicpy_dlpack_export *)PyMem_RawMalloc(sizeof(gmicpy_dlpack_export));
+    if (dlpack_export == NULL) {
+        Py_DECREF(image);
+        return PyErr_NoMemory();
+    }
+    dlpack_export->shape[0] = image->_gmic_image->_width;
+    dlpack_export->shape[1] = image->_gmic_image->_height;
+    dlpack_export->shape[2] = image->_gmic_image->_depth;
+    dlpack_export->shape[3] = image->_gmic_image->_spectrum;
+    dlpack_export->strides[0] = 1;
+    dlpack_export->strides[1] = dlpack_export->shape[0];
+    dlpack_export->strides[2] =
+        dlpack_export->strides[1] * dlpack_export->shape[1];
+    dlpack_export->strides[3] =
+        dlpack_export->strides[2] * dlpack_export->shape[2];
+
+    gmicpy_dl_tensor &tensor = dlpack_export->managed_tensor.dl_tensor;
+    tensor.data = image->_gmic_image->_data;
+    tensor.device.device_type = GMICPY_DL_CPU;
+    tensor.device.device_id = 0;
+    tensor.ndim = 4;
+    tensor.dtype.code = GMICPY_DL_FLOAT;
+    tensor.dtype.bits = sizeof(T) * 8;
+    tensor.dtype.lanes = 1;
+    tensor.shape = dlpack_export->shape;
+    tensor.strides = dlpack_export->strides;
+    tensor.byte_offset = 0;
+    // The image reference is handed over to the tensor
+    dlpack_export->managed_tensor.manager_ctx = image;
+    dlpack_export->managed_tensor.deleter = gmicpy_dlpack_export_deleter;
+    image->_exports++;
+
+    capsule = PyCapsule_New(&dlpack_export->managed_tensor, "dltensor",
+                            gmicpy_dlpack_capsule_destructor);
+    if (capsule == NULL) {
+        gmicpy_dlpack_export_deleter(&dlpack_export->managed_tensor);
+    }
+
+    return capsule;
+}
+
+PyDoc_STRVAR(PyGmicImage___dlpack_device___doc,
+             "GmicImage.__dlpack_device__()\n\n\
+Return the DLPack device of this image's pixels, which is always the CPU.\n\n\
+Returns:\n\
+    tuple: ``(1, 0)``.");
+
+static PyObject *
+PyGmicImage___dlpack_device__(PyGmicImage *self, PyObject *args)
+{
+    return Py_BuildValue("(ii)", GMICPY_DL_CPU, 0);
+}
+
+PyDoc_STRVAR(PyGmicImage_from_dlpack_doc,
+             "GmicImage.from_dlpack(tensor, copy=False)\n\n\
+Make a GmicImage from a CPU tensor of any array library supporting DLPack (eg. ``numpy.ndarray`` or ``torch.Tensor``), or from a \"dltensor\" capsule.\n\
+The axes of a 4D tensor are read as (width, height, depth, spectrum), so that ``image(x, y, z, c) == tensor[x, y, z, c]``, 3D tensors being (width, height, spectrum) ones and 1-2D tensors (width[, height]) ones. For example, a C-ordered (spectrum, height, width) tensor ``t`` converts through ``t.permute(2, 1, 0)`` in PyTorch, or ``t.T`` in numpy.\n\n\
+Float32 tensors with Fortran-ordered compact strides (ie. G'MIC's planar layout) are shared rather than copied, the same way as ``GmicImage.from_numpy_helper(copy=False)``. Other ones are cast and gathered into a new buffer in a single pass. Tensors viewing packed (height, width, spectrum) C-ordered pixels, such as ``numpy_image.transpose(1, 0, 2)``, get deinterleaved the same way as with ``GmicImage.from_numpy()``.\n\n\
+Args:\n\
+    tensor: An object with a ``__dlpack__()`` method, or a \"dltensor\" capsule.\n\
+    copy (Optional[bool]): If ``True``, always copy pixels.\n\
+        Defaults to ``False``.\n\
+\n\
+Returns:\n\
+    gmic.GmicImage: A new ``gmic.GmicImage``.\n\
+\n\
+Raises:\n\
+    BufferError: If the tensor does not live on the CPU.\n\
+    TypeError: If the tensor's item type is not a bool, 8 to 32-bit integer or 32 to 64-bit float one.\n\
+    GmicException: If the tensor has less than 1 or more than 4 axes.");
+
+static PyObject *
+PyGmicImage_from_dlpack(PyObject *cls, PyObject *args, PyObject *kwargs)
+{
+    char const *keywords[] = {"tensor", "copy", NULL};
+    PyObject *arg_tensor = NULL;
+    int arg_copy = 0;
+    PyObject *capsule = NULL;
+    PyObject *owner_capsule = NULL;
+    gmicpy_dl_managed_tensor *managed_tensor = NULL;
+    PyGmicImage *image = NULL;
+    int64_t shape[4] = {1, 1, 1, 1};
+    int64_t strides[4] = {0, 0, 0, 0};
+    int64_t compact_stride = 1;
+    bool can_share = true;
+    char format = 0;
+    char *data = NULL;
+
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|p", (char **)keywords,
+                                     &arg_tensor, &arg_copy)) {
+        return NULL;
+    }
+
+    if (PyCapsule_IsValid(arg_tensor, "dltensor")) {
+        capsule = arg_tensor;
+        Py_INCREF(capsule);
+    }
+    else {
+        capsule = PyObject_CallMethod(arg_tensor, "__dlpack__", NULL);
+        if (capsule == NULL) {
+            return NULL;
+        }
+    }
+    managed_tensor = (gmicpy_dl_managed_tensor *)PyCapsule_GetPointer(
+        capsule, "dltensor");
+    if (managed_tensor == NULL) {
+        Py_DECREF(capsule);
+        return NULL;
+    }
+
+    gmicpy_dl_tensor &tensor = managed_tensor->dl_tensor;
+    if (tensor.device.device_type != GMICPY_DL_CPU) {
+        PyErr_Format(PyExc_BufferError,
+                     "GmicImage can only be made from CPU tensors, not from "
+                     "DLPack device type %d.",
+                     tensor.device.device_type);
+        Py_DECREF(capsule);
+        return NULL;
+    }
+    if (tensor.ndim < 1 || tensor.ndim > 4) {
+        PyErr_Format(GmicException,
+                     "Provided tensor must be between 1D and 4D (%d "
+                     "dimensions found).",
+                     tensor.ndim);
+        Py_DECREF(capsule);
+        return NULL;
+    }
+    format = gmicpy_dlpack_format(tensor.dtype);
+    if (format == 0) {
+        PyErr_Format(PyExc_TypeError,
+                     "Provided tensor's DLPack item type (code %d, %d bits, "
+                     "%d lanes) is not a bool, 8 to 32-bit integer or 32 to "
+                     "64-bit float one.",
+                     tensor.dtype.code, tensor.dtype.bits, tensor.dtype.lanes);
+        Py_DECREF(capsule);
+        return NULL;
+    }
+
+    // Tensors without strides are compact C-ordered ones. The last axis
+    // of 3D tensors is the spectrum one, as with numpy arrays.
+    for (int axis = tensor.ndim - 1; axis >= 0; axis--) {
+        int image_axis = tensor.ndim == 3 && axis == 2 ? 3 : axis;
+        shape[image_axis] = tensor.shape[axis];
+        strides[image_axis] = tensor.strides != NULL ? tensor.strides[axis]
+                                                     : compact_stride;
+        compact_stride *= tensor.shape[axis];
+    }
+    // G'MIC's planar layout has compact Fortran-ordered strides
+    compact_stride = 1;
+    for (int axis = 0; axis < 4; axis++) {
+        can_share &= shape[axis] == 1 || strides[axis] == compact_stride;
+        compact_stride *= shape[axis];
+    }
+    can_share &= !arg_copy && format == 'f' && sizeof(T) == sizeof(float) &&
+                 compact_stride > 0;
+    data = (char *)tensor.data + tensor.byte_offset;
+
+    image = (PyGmicImage *)PyGmicImageType.tp_alloc(&PyGmicImageType, 0);
+    if (image == NULL) {
+        Py_DECREF(capsule);
+        return NULL;
+    }
+
+    // A shared tensor is taken over from its capsule, and deleted along
+    // with the owner capsule once the GmicImage stops sharing its pixels
+    if (can_share) {
+        owner_capsule = PyCapsule_New(managed_tensor, "gmic.dltensor_owner",
+                                      gmicpy_dlpack_owner_destructor);
+        if (owner_capsule == NULL) {
+            Py_DECREF(image);
+            Py_DECREF(capsule);
+            return NULL;
+        }
+        PyCapsule_SetName(capsule, "used_dltensor");
+        image->_gmic_image->assign((T *)data, (unsigned int)shape[0],
+                                   (unsigned int)shape[1],
+                                   (unsigned int)shape[2],
+                                   (unsigned int)shape[3], true);
+        memset(&image->_owner_buffer, 0, sizeof(Py_buffer));
+        image->_owner_buffer.buf = data;
+        image->_owner_buffer.obj = owner_capsule;
+        image->_owner_buffer.len = (Py_ssize_t)(compact_stride * sizeof(T));
+        image->_owner_buffer.itemsize = sizeof(T);
+        Py_DECREF(capsule);
+
+        return (PyObject *)image;
+    }
+
+    try {
+        image->_gmic_image->assign(
+            (unsigned int)shape[0], (unsigned int)shape[1],
+            (unsigned int)shape[2], (unsigned int)shape[3]);
+    }
+    catch (...) {
+        PyErr_Format(PyExc_MemoryError,
+                     "Allocation error in GmicImage::assign(_width=%d,_"
+                     "height=%d,_depth=%d,_spectrum=%d), are you requesting "
+                     "too much memory?",
+                     (int)shape[0], (int)shape[1], (int)shape[2],
+                     (int)shape[3]);
+        Py_DECREF(image);
+        Py_DECREF(capsule);
+        return NULL;
+    }
+    if (!image->_gmic_image->is_empty()) {
+        gmicpy_import_strided_pixels_from(data, format, strides,
+                                          *image->_gmic_image);
+    }
+    // The capsule's destructor deletes the consumed tensor
+    Py_DECREF(capsule);
+
+    return (PyObject *)image;
+}
 
 static PyObject *
 PyGmicImage_get_width(PyGmicImage *self, void *closure)
@@ -1645,6 +6704,26 @@ PyGetSetDef PyGmicImage_getsets[] = {
 
 #ifdef gmic_py_numpy
 
+/* Whether a numpy.dtype is one of the native C types that GmicImage pixels
+ * can be cast into while being copied. */
+static bool
+gmicpy_numpy_dtype_is_castable(PyObject *dtype)
+{
+    PyObject *is_native = PyObject_GetAttrString(dtype, "isnative");
+    PyObject *dtype_char = PyObject_GetAttrString(dtype, "char");
+    bool is_castable = is_native != NULL && dtype_char != NULL &&
+                       PyObject_IsTrue(is_native) &&
+                       PyUnicode_GetLength(dtype_char) == 1 &&
+                       strchr("?bBhHiIfd", (char)PyUnicode_ReadChar(
+                                               dtype_char, 0)) != NULL;
+
+    Py_XDECREF(is_native);
+    Py_XDECREF(dtype_char);
+    PyErr_Clear();
+
+    return is_castable;
+}
+
 /*
  * GmicImage object method to_numpy_helper().
  *
@@ -1656,8 +6735,8 @@ static PyObject *
 PyGmicImage_to_numpy_helper(PyGmicImage *self, PyObject *args,
                             PyObject *kwargs)
 {
-    char const *keywords[] = {"astype", "interleave", "permute",
-                              "squeeze_shape", NULL};
+    char const *keywords[] = {"astype",        "interleave", "permute",
+                              "squeeze_shape", "copy",       NULL};
     PyObject *numpy_module = NULL;
     PyObject *ndarray_type = NULL;
     PyObject *return_ndarray = NULL;
@@ -1666,10 +6745,9 @@ PyGmicImage_to_numpy_helper(PyGmicImage *self, PyObject *args,
     PyObject *ndarray_shape_list = NULL;
     PyObject *ndarray_transpose_list = NULL;
     PyObject *float32_dtype = NULL;
-    PyObject *numpy_bytes_buffer = NULL;
-    float *numpy_buffer = NULL;
-    float *ndarray_bytes_buffer_ptr = NULL;
-    int buffer_size = 0;
+    PyObject *output_dtype = NULL;
+    Py_buffer ndarray_buffer;
+    gmicpy_pixels_layout pixels_layout = GMICPY_PIXELS_PLANAR;
     // Defaults to numpy.float32
     PyObject *arg_astype = NULL;
     int arg_interleave = -1;
@@ -1679,11 +6757,13 @@ PyGmicImage_to_numpy_helper(PyGmicImage *self, PyObject *args,
     int arg_squeeze_shape_default = 0;  // Will not squeeze shape by default
     char *arg_permute = NULL;
     char arg_permute_default[] = "xyzc";
+    int arg_copy = 1;  // Copies pixels by default, for backward compatibility
     size_t permute_axis = 0;  // iterator
 
-    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|Opsp", (char **)keywords,
+    if (!PyArg_ParseTupleAndKeywords(args, kwargs, "|Opspp", (char **)keywords,
                                      &arg_astype, &arg_interleave,
-                                     &arg_permute, &arg_squeeze_shape)) {
+                                     &arg_permute, &arg_squeeze_shape,
+                                     &arg_copy)) {
         return NULL;
     }
 
@@ -1750,39 +6830,104 @@ PyGmicImage_to_numpy_helper(PyGmicImage *self, PyObject *args,
     ndarray_type = PyObject_GetAttrString(numpy_module, "ndarray");
 
     float32_dtype = PyObject_GetAttrString(numpy_module, "float32");
-    buffer_size = sizeof(T) * self->_gmic_image->size();
-    numpy_buffer = (float *)malloc(buffer_size);
-    ndarray_bytes_buffer_ptr = numpy_buffer;
-    // If interleaving is needed, copy the gmic_image buffer towards
-    // numpy by interleaving RRR,GGG,BBB into RGB,RGB,RGB
-    if (arg_interleave) {
-        for (unsigned int x = 0; x < self->_gmic_image->_width; x++) {
-            for (unsigned int y = 0; y < self->_gmic_image->_height; y++) {
-                for (unsigned int z = 0; z < self->_gmic_image->_depth; z++) {
-                    for (unsigned int c = 0; c < self->_gmic_image->_spectrum;
-                         c++) {
-                        (*ndarray_bytes_buffer_ptr++) =
-                            (*(self->_gmic_image))(x, y, z, c);
-                    }
-                }
+
+    if (!arg_copy) {
+        // Zero-copy mode: numpy.asarray(self) goes through the buffer
+        // protocol and yields a writable (w,h,d,s) Fortran-ordered view,
+        // which reads pixels as interleaved. The view's base memoryview
+        // holds a buffer export on self, keeping the pixels alive and in
+        // place as long as the array lives.
+        return_ndarray =
+            PyObject_CallMethod(numpy_module, "asarray", "O", self);
+        if (return_ndarray != NULL && !arg_interleave) {
+            // Mimic the copying mode's raw G'MIC memory layout, reshaped
+            // in C order, through a flat view
+            _tmp_return_ndarray = PyObject_CallMethod(return_ndarray,
+                                                      "ravel", "s", "F");
+            Py_DECREF(return_ndarray);
+            return_ndarray = NULL;
+            if (_tmp_return_ndarray != NULL) {
+                return_ndarray =
+                    PyObject_CallMethod(_tmp_return_ndarray, "reshape", "O",
+                                        ndarray_shape_tuple);
+                Py_DECREF(_tmp_return_ndarray);
             }
         }
     }
     else {
-        // If deinterleaving is not needed, since this is G'MIC's
-        // internal image shape, keep pixel data order as is and copy
-        // it simply
-        memcpy(numpy_buffer, self->_gmic_image->_data,
-               self->_gmic_image->size() * sizeof(T));
-    }
-    numpy_bytes_buffer =
-        PyBytes_FromStringAndSize((const char *)numpy_buffer, buffer_size);
-    free(numpy_buffer);
-    // class numpy.ndarray(<our shape>, dtype=<float32>, buffer=<our
-    // bytes>, offset=0, strides=None, order=None)
-    return_ndarray = PyObject_CallFunction(ndarray_type, (const char *)"OOS",
-                                           ndarray_shape_tuple, float32_dtype,
-                                           numpy_bytes_buffer);
+        // Pixel values are cast while being copied into the output matrix
+        // if astype is a native dtype of a common C type. Other dtypes get
+        // float32 pixels, cast by numpy.ndarray.astype() afterwards.
+        output_dtype = float32_dtype;
+        Py_INCREF(output_dtype);
+        if (arg_astype != NULL && arg_astype != Py_None) {
+            Py_DECREF(output_dtype);
+            output_dtype =
+                PyObject_CallMethod(numpy_module, "dtype", "O", arg_astype);
+            if (output_dtype != NULL &&
+                gmicpy_numpy_dtype_is_castable(output_dtype)) {
+                arg_astype = NULL;  // Nothing left to cast
+            }
+            else if (output_dtype != NULL) {
+                Py_DECREF(output_dtype);
+                output_dtype = float32_dtype;
+                Py_INCREF(output_dtype);
+            }
+            // Unknown dtypes are left for numpy.ndarray.astype() to reject
+            else {
+                PyErr_Clear();
+                output_dtype = float32_dtype;
+                Py_INCREF(output_dtype);
+            }
+        }
+
+        // If interleaving is needed, copy the gmic_image buffer towards
+        // numpy by interleaving RRR,GGG,BBB into RGB,RGB,RGB
+        if (arg_interleave && strcmp(arg_permute, "zyxc") == 0) {
+            // A (depth, height, width, spectrum) C-ordered matrix has
+            // G'MIC's pixels order, so it is built directly rather than
+            // transposed afterwards (eg. for PIL)
+            pixels_layout = GMICPY_PIXELS_INTERLEAVED;
+            Py_DECREF(ndarray_shape_tuple);
+            ndarray_shape_tuple = Py_BuildValue(
+                "(IIII)", self->_gmic_image->_depth,
+                self->_gmic_image->_height, self->_gmic_image->_width,
+                self->_gmic_image->_spectrum);
+            arg_permute = NULL;
+        }
+        else if (arg_interleave) {
+            pixels_layout = GMICPY_PIXELS_INTERLEAVED_X_MAJOR;
+        }
+        // If deinterleaving is not needed, since this is G'MIC's internal
+        // image shape, keep pixel data order as is
+        else {
+            pixels_layout = GMICPY_PIXELS_PLANAR;
+        }
+
+        return_ndarray = PyObject_CallMethod(numpy_module, "empty", "OO",
+                                             ndarray_shape_tuple, output_dtype);
+        Py_DECREF(output_dtype);
+        if (return_ndarray != NULL &&
+            PyObject_GetBuffer(return_ndarray, &ndarray_buffer,
+                               PyBUF_WRITABLE | PyBUF_C_CONTIGUOUS |
+                                   PyBUF_FORMAT) < 0) {
+            Py_CLEAR(return_ndarray);
+        }
+        if (return_ndarray != NULL) {
+            gmicpy_export_pixels_to(*self->_gmic_image, ndarray_buffer.buf,
+                                    ndarray_buffer.format[0], pixels_layout);
+            PyBuffer_Release(&ndarray_buffer);
+        }
+    }
+    if (!return_ndarray) {
+        Py_XDECREF(ndarray_type);
+        Py_XDECREF(ndarray_shape_list);
+        Py_XDECREF(ndarray_shape_tuple);
+        Py_XDECREF(ndarray_transpose_list);
+        Py_XDECREF(float32_dtype);
+        Py_XDECREF(numpy_module);
+        return NULL;
+    }
 
     // arg_astype should be according to ndarray.astype's
     // documentation, a string, python type or numpy.dtype delegating
@@ -1796,9 +6941,29 @@ PyGmicImage_to_numpy_helper(PyGmicImage *self, PyObject *args,
             arg_astype = float32_dtype;
         }
 
-        return_ndarray =
-            PyObject_CallMethod(return_ndarray, "astype", "O", arg_astype);
+        if (arg_copy) {
+            return_ndarray = PyObject_CallMethod(return_ndarray, "astype",
+                                                 "O", arg_astype);
+        }
+        else {
+            // Keeps the view when no cast is needed, copies otherwise.
+            // 'copy' is keyword-only in practice, the second positional
+            // parameter of astype() being 'order'.
+            PyObject *astype_method =
+                PyObject_GetAttrString(return_ndarray, "astype");
+            PyObject *astype_args = PyTuple_Pack(1, arg_astype);
+            PyObject *astype_kwargs = Py_BuildValue("{s:O}", "copy", Py_False);
+            return_ndarray =
+                astype_method != NULL && astype_args != NULL &&
+                        astype_kwargs != NULL
+                    ? PyObject_Call(astype_method, astype_args, astype_kwargs)
+                    : NULL;
+            Py_XDECREF(astype_method);
+            Py_XDECREF(astype_args);
+            Py_XDECREF(astype_kwargs);
+        }
         if (!return_ndarray) {
+            Py_DECREF(_tmp_return_ndarray);
             PyErr_Format(GmicException,
                          "'%.50s' failed to run numpy.ndarray.astype.",
                          ((PyTypeObject *)Py_TYPE(ndarray_type))->tp_name);
@@ -1852,7 +7017,6 @@ PyGmicImage_to_numpy_helper(PyGmicImage *self, PyObject *args,
     Py_XDECREF(ndarray_shape_tuple);
     Py_XDECREF(ndarray_transpose_list);
     Py_XDECREF(float32_dtype);
-    Py_XDECREF(numpy_bytes_buffer);
     Py_XDECREF(numpy_module);
 
     return return_ndarray;
@@ -1862,11 +7026,13 @@ PyGmicImage_to_numpy_helper(PyGmicImage *self, PyObject *args,
 
 #ifdef gmic_py_numpy
 PyDoc_STRVAR(PyGmicImage_from_numpy_doc,
-             "GmicImage.from_numpy(numpy_array)\n\n\
+             "GmicImage.from_numpy(numpy_array, copy=True)\n\n\
 Make a GmicImage from a 1-4 dimensions numpy.ndarray. Simplified version of ``GmicImage.from_numpy_helper`` with ``deinterleave=True``.\n\n\
 \n\
 Args:\n\
     numpy_array (numpy.ndarray): A non-empty 1D-4D Numpy array.\n\
+    copy (Optional[bool]): If ``False``, share the pixels of a compatible array rather than copying them. See ``GmicImage.from_numpy_helper``.\n\
+        Defaults to ``True``.\n\
 \n\
 Returns:\n\
     GmicImage: A new ``GmicImage`` based the input ``numpy.ndarray`` data.\n\
@@ -1875,19 +7041,24 @@ Raises:\n\
     GmicException, TypeError: Look at the exception message for details. Matrices with dimensions <1D or >4D will be rejected.");
 
 PyDoc_STRVAR(PyGmicImage_to_numpy_doc,
-             "GmicImage.to_numpy()\n\n\
+             "GmicImage.to_numpy(copy=True)\n\n\
 Make a numpy.ndarray from a GmicImage. Simplified version of ``GmicImage.to_numpy_helper`` with ``interleave=True``.\n\
 \n\
+Args:\n\
+    copy (Optional[bool]): If ``False``, return a writable view over the GmicImage pixels instead of a copy. See ``GmicImage.to_numpy_helper``.\n\
+        Defaults to ``True``.\n\
+\n\
 Returns:\n\
     numpy.ndarray: A new ``numpy.ndarray`` based the input ``GmicImage`` data.");
 
 PyDoc_STRVAR(
     PyGmicImage_from_numpy_helper_doc,
-    "GmicImage.from_numpy_helper(numpy_array, deinterleave=False, permute='')\n\n\
+    "GmicImage.from_numpy_helper(numpy_array, deinterleave=False, permute='', copy=True)\n\n\
 Make a GmicImage from a 1-4 dimensions numpy.ndarray.\n\n\
 G'MIC works with (width, height, depth, spectrum/channels) matrix layout, with 32bit-float pixel values deinterleaved (ie. RRR,GGG,BBB).\n\
 If your matrix is less than 4D, G'MIC will tentatively add append void dimensions to it (eg. for a shape of (3,1) -> (3,1,1,1)). You can avoid this by using ``numpy.expand_dims`` or ``numpy.atleast_*d`` functions yourself first.\n\
-If your pixel values (ie. ``numpy.ndarray.dtype``) are not in a ``float32`` format, G'MIC will tentatively call ``numpy.astype(numpy_array, numpy.float32)`` to cast its contents first.\n\
+Large matrices are converted by several threads, see ``GmicImage.to_numpy_helper``.\n\
+If your pixel values (ie. ``numpy.ndarray.dtype``) are not in a ``float32`` format, they are cast while being copied for ``bool``, ``int8``, ``uint8``, ``int16``, ``uint16``, ``int32``, ``uint32`` and ``float64`` matrices. For other types, G'MIC will tentatively call ``numpy.ascontiguousarray(numpy_array, numpy.float32)`` to cast its contents first.\n\
 \n\
 Example:\n\n\
     Several ways to use a GmicImage simply::\n\n\
@@ -1908,6 +7079,8 @@ Args:\n\
     permute (Optional[str]): If non-empty, a G'MIC ``permute`` operation will be run with this parameter (eg. yxzc) on the input matrix before saving into the GmicImage.\n\
         See https://gmic.eu/reference.shtml#permute\n\
         Defaults to \"\" (no permutation).\n\
+    copy (Optional[bool]): If ``False`` and the array is already laid out as G'MIC pixels (ie. a writable C-contiguous ``float32`` matrix, with ``deinterleave=False`` or a single channel), the GmicImage shares the array's memory instead of copying it, and keeps a reference to the array. G'MIC runs on that single GmicImage write their results back into the array, unless they change its dimensions: the GmicImage then gets a buffer of its own and stops sharing. Other arrays are copied.\n\
+        Defaults to ``True``.\n\
 \n\
 Returns:\n\
     GmicImage: A new ``GmicImage`` based the input ``numpy.ndarray`` data.\n\
@@ -1917,26 +7090,32 @@ Raises:\n\
 
 PyDoc_STRVAR(
     PyGmicImage_to_numpy_helper_doc,
-    "GmicImage.to_numpy_helper(astype=numpy.float32, interleave=False, permute='', squeeze_shape=False)\n\n\
+    "GmicImage.to_numpy_helper(astype=numpy.float32, interleave=False, permute='', squeeze_shape=False, copy=True)\n\n\
 Make a numpy.ndarray from a GmicImage.\n\
-G'MIC does not squeeze dimensions internally, so unless you use the ``squeeze_shape`` flag calling ``numpy.squeeze`` for you, the output matrix will be 4D.\n\n\
+G'MIC does not squeeze dimensions internally, so unless you use the ``squeeze_shape`` flag calling ``numpy.squeeze`` for you, the output matrix will be 4D.\n\
+Images of more than a million pixel values are converted by several OpenMP threads: as many as G'MIC commands use, unless the ``GMIC_PY_CONVERSION_THREADS`` environment variable sets another count.\n\n\
 Args:\n\
     astype (numpy.dtype): The type to which G'MIC's float32 pixel values will cast to for the output matrix.\n\
+        ``bool``, ``int8``, ``uint8``, ``int16``, ``uint16``, ``int32``, ``uint32`` and ``float64`` pixels are cast while being copied, integer ones being rounded and clamped to the type's range (eg. -3.2 and 300.0 become 0 and 255 in ``uint8``). Other types go through ``numpy.ndarray.astype``.\n\
     interleave (Optional[bool]): If ``True``, pixel channel values will be interleaved (ie. RGB, RGB, RGB) within the numpy array. If ``False``, pixel channels vector values will be untouched/deinterleaved (ie. RRR,GGG,BBB).\n\
         Defaults to ``False``.\n\
     permute (Optional[str]): If non-empty, a G'MIC ``permute`` operation will be run with this parameter (eg. yxzc) on the output matrix before saving into the GmicImage.\n\
         See https://gmic.eu/reference.shtml#permute\n\
         Defaults to \"\" (ie. no permutation).\n\
+    copy (Optional[bool]): If ``False``, no pixel is copied: the output matrix is a writable view over the GmicImage's own buffer, with interleaving, permutation and squeezing done by strides only. The view keeps the GmicImage alive through its ``base`` memoryview, and while it exists G'MIC runs write their results into that same buffer or raise ``BufferError`` if the image size changes. An ``astype`` other than ``numpy.float32`` still requires a copy.\n\
+        Defaults to ``True``.\n\
 \n\
 Returns:\n\
     numpy.ndarray: A new ``numpy.ndarray`` based the input ``GmicImage`` data.");
 
+#endif
+
 PyDoc_STRVAR(
     PyGmicImage_to_PIL_doc,
     "GmicImage.to_PIL(astype=numpy.uint8, squeeze_shape=True, mode='RGB')\n\n\
 Make a 2D 8-bit per pixel RGB PIL.Image from any GmicImage.\n\
-Equates to ``PIL.Image.fromarray(self.to_numpy_helper(astype=astype, squeeze_shape=squeeze_shape, interleave=True, permute='zyxc'), mode)``. Will import ``PIL.Image`` and ``numpy``.\n\n\
-This method uses ``numpy`` for conversion. Thus ``astype`` is used in a ``numpy.ndarray.astype()` conversion pass and samewise for ``squeeze_shape``.\n\
+Equates to ``PIL.Image.fromarray(self.to_numpy_helper(astype=astype, squeeze_shape=squeeze_shape, interleave=True, permute='zyxc'), mode)``. Will import ``PIL.Image``.\n\n\
+2D images whose channels and ``astype`` match one of the L, LA, RGB, RGBA (``numpy.uint8``), I;16 (``numpy.uint16``), I (``numpy.int32``) or F (``numpy.float32``) modes are written straight into the PIL image's raw bytes, with integer values rounded and clamped. Otherwise this method uses ``numpy`` for conversion. Thus ``astype`` is used in a ``numpy.ndarray.astype()` conversion pass and samewise for ``squeeze_shape``.\n\
 Args:\n\
     astype (type): Will be used for casting your image's pixel.\n\
     squeeze_shape (bool): if True, your image shape has '1' components removed, is usually necessary to convert from G'MIC 3D to PIL.Image 2D only.\n\
@@ -1948,7 +7127,8 @@ Returns:\n\
 PyDoc_STRVAR(PyGmicImage_from_PIL_doc,
              "GmicImage.from_PIL(pil_image)\n\n\
 Make a ``GmicImage`` from a 2D ``PIL.Image.Image`` object.\n\
-Equates to ``gmic.GmicImage.from_numpy_helper(numpy.array(pil_image), deinterleave=True)``. Will import ``PIL.Image`` and ``numpy`` for conversion.\n\n\
+Equates to ``gmic.GmicImage.from_numpy_helper(numpy.array(pil_image), deinterleave=True)``. Will import ``PIL.Image``.\n\n\
+Images of the L, LA, RGB, RGBA, I;16, I or F modes are read straight from their raw bytes. Other modes are converted through ``numpy``.\n\n\
 \n\
 Args:\n\
     pil_image (PIL.Image.Image): An image to convert into ``GmicImage``.\n\
@@ -1956,8 +7136,6 @@ Args:\n\
 Returns:\n\
     gmic.GmicImage: A new ``gmic.GmicImage`` based on the input ``PIL.Image.Image`` data.");
 
-#endif
-
 static PyObject *
 PyGmicImage__copy__(PyGmicImage *self, PyObject *args)
 {
@@ -1989,12 +7167,6 @@ static PyMethodDef PyGmicImage_methods[] = {
      METH_VARARGS | METH_KEYWORDS,
      PyGmicImage_to_numpy_helper_doc},  // TODO create and set doc variable
 
-    // PIL (Pillow) Input / Output
-    {"from_PIL", (PyCFunction)PyGmicImage_from_PIL,
-     METH_CLASS | METH_VARARGS | METH_KEYWORDS, PyGmicImage_from_PIL_doc},
-    {"to_PIL", (PyCFunction)PyGmicImage_to_PIL, METH_VARARGS | METH_KEYWORDS,
-     PyGmicImage_to_PIL_doc},
-
     // Scikit image
     {"to_skimage", (PyCFunction)PyGmicImage_to_skimage,
      METH_VARARGS | METH_KEYWORDS,
@@ -2003,6 +7175,23 @@ static PyMethodDef PyGmicImage_methods[] = {
      METH_CLASS | METH_VARARGS | METH_KEYWORDS,
      PyGmicImage_from_numpy_helper_doc},  // TODO create and set doc variable
 #endif
+    // PIL (Pillow) Input / Output
+    {"from_PIL", (PyCFunction)PyGmicImage_from_PIL,
+     METH_CLASS | METH_VARARGS | METH_KEYWORDS, PyGmicImage_from_PIL_doc},
+    {"to_PIL", (PyCFunction)PyGmicImage_to_PIL, METH_VARARGS | METH_KEYWORDS,
+     PyGmicImage_to_PIL_doc},
+    // DLPack tensors exchange with array libraries
+    {"from_dlpack", (PyCFunction)PyGmicImage_from_dlpack,
+     METH_CLASS | METH_VARARGS | METH_KEYWORDS, PyGmicImage_from_dlpack_doc},
+    {"__dlpack__", (PyCFunction)PyGmicImage___dlpack__,
+     METH_VARARGS | METH_KEYWORDS, PyGmicImage___dlpack___doc},
+    {"__dlpack_device__", (PyCFunction)PyGmicImage___dlpack_device__,
+     METH_NOARGS, PyGmicImage___dlpack_device___doc},
+    // Pixel values at many coordinates at once
+    {"gather", (PyCFunction)PyGmicImage_gather, METH_VARARGS | METH_KEYWORDS,
+     PyGmicImage_gather_doc},
+    {"scatter", (PyCFunction)PyGmicImage_scatter,
+     METH_VARARGS | METH_KEYWORDS, PyGmicImage_scatter_doc},
     {"__copy__", (PyCFunction)PyGmicImage__copy__, METH_VARARGS,
      "Copy method for copy.copy() support. Deepcopying and pickle-ing "
      "are not "
@@ -2070,6 +7259,12 @@ PyInit_gmic()
                                                                 */
                                   NULL, /* PyObject *base */
                                   NULL /* PyObject *dict */);
+    // Raised when a run is stopped by Gmic.abort() or its timeout.
+    GmicAborted = PyErr_NewExceptionWithDoc(
+        "gmic.GmicAborted",
+        "Raised when a G'MIC run is stopped by Gmic.abort() or by its "
+        "'timeout' parameter.\n\nIt inherits gmic.GmicException.",
+        GmicException, NULL);
 
     PyGmicImageType.tp_new = (newfunc)PyGmicImage_new;
     PyGmicImageType.tp_init = 0;
@@ -2085,6 +7280,8 @@ PyInit_gmic()
     PyGmicImageType.tp_members = NULL;
     PyGmicImageType.tp_getset = PyGmicImage_getsets;
     PyGmicImageType.tp_richcompare = PyGmicImage_richcompare;
+    PyGmicImageType.tp_as_buffer = &PyGmicImage_as_buffer;
+    PyGmicImageType.tp_as_mapping = &PyGmicImage_as_mapping;
     PyGmicImageType.tp_flags = Py_TPFLAGS_DEFAULT | Py_TPFLAGS_BASETYPE;
 
     if (PyType_Ready(&PyGmicImageType) < 0)
@@ -2093,6 +7290,7 @@ PyInit_gmic()
     PyGmicType.tp_new = (newfunc)PyGmic_new;
     PyGmicType.tp_basicsize = sizeof(PyGmic);
     PyGmicType.tp_methods = PyGmic_methods;
+    PyGmicType.tp_getset = PyGmic_getsets;
     PyGmicType.tp_repr = (reprfunc)PyGmic_repr;
     PyGmicType.tp_init = 0;
     PyGmicType.tp_alloc = (allocfunc)PyGmic_alloc;
@@ -2104,6 +7302,44 @@ PyInit_gmic()
     if (PyType_Ready(&PyGmicType) < 0)
         return NULL;
 
+    PyGmicPoolType.tp_new = (newfunc)PyGmicPool_new;
+    PyGmicPoolType.tp_basicsize = sizeof(PyGmicPool);
+    PyGmicPoolType.tp_methods = PyGmicPool_methods;
+    PyGmicPoolType.tp_getset = PyGmicPool_getsets;
+    PyGmicPoolType.tp_repr = (reprfunc)PyGmicPool_repr;
+    PyGmicPoolType.tp_doc = PyGmicPool_doc;
+    PyGmicPoolType.tp_getattro = PyObject_GenericGetAttr;
+    PyGmicPoolType.tp_dealloc = (destructor)PyGmicPool_dealloc;
+    PyGmicPoolType.tp_flags = Py_TPFLAGS_DEFAULT;
+
+    if (PyType_Ready(&PyGmicPoolType) < 0)
+        return NULL;
+
+    PyGmicStreamType.tp_basicsize = sizeof(PyGmicStream);
+    PyGmicStreamType.tp_repr = (reprfunc)PyGmicStream_repr;
+    PyGmicStreamType.tp_doc = PyGmicStream_doc;
+    PyGmicStreamType.tp_getattro = PyObject_GenericGetAttr;
+    PyGmicStreamType.tp_iter = PyObject_SelfIter;
+    PyGmicStreamType.tp_iternext = (iternextfunc)PyGmicStream_next;
+    PyGmicStreamType.tp_dealloc = (destructor)PyGmicStream_dealloc;
+    PyGmicStreamType.tp_flags = Py_TPFLAGS_DEFAULT;
+
+    if (PyType_Ready(&PyGmicStreamType) < 0)
+        return NULL;
+
+    PyGmicSessionType.tp_basicsize = sizeof(PyGmicSession);
+    PyGmicSessionType.tp_methods = PyGmicSession_methods;
+    PyGmicSessionType.tp_getset = PyGmicSession_getsets;
+    PyGmicSessionType.tp_as_sequence = &PyGmicSession_as_sequence;
+    PyGmicSessionType.tp_repr = (reprfunc)PyGmicSession_repr;
+    PyGmicSessionType.tp_doc = PyGmicSession_doc;
+    PyGmicSessionType.tp_getattro = PyObject_GenericGetAttr;
+    PyGmicSessionType.tp_dealloc = (destructor)PyGmicSession_dealloc;
+    PyGmicSessionType.tp_flags = Py_TPFLAGS_DEFAULT;
+
+    if (PyType_Ready(&PyGmicSessionType) < 0)
+        return NULL;
+
     m = PyModule_Create(&gmic_module);
     if (m == NULL) {
         return NULL;
@@ -2116,16 +7352,32 @@ PyInit_gmic()
 
     Py_INCREF(&PyGmicImageType);
     Py_INCREF(&PyGmicType);
+    Py_INCREF(&PyGmicPoolType);
+    Py_INCREF(&PyGmicStreamType);
+    Py_INCREF(&PyGmicSessionType);
     Py_INCREF(GmicException);
+    Py_INCREF(GmicAborted);
     PyModule_AddObject(m, "GmicImage",
                        (PyObject *)&PyGmicImageType);  // Add GmicImage object
                                                        // to the module
     PyModule_AddObject(
         m, "Gmic",
         (PyObject *)&PyGmicType);  // Add Gmic object to the module
+    PyModule_AddObject(
+        m, "GmicPool",
+        (PyObject *)&PyGmicPoolType);  // Add GmicPool object to the module
+    PyModule_AddObject(
+        m, "GmicStream",
+        (PyObject *)&PyGmicStreamType);  // Add GmicStream object to the module
+    PyModule_AddObject(m, "GmicSession",
+                       (PyObject *)&PyGmicSessionType);  // Add GmicSession
+                                                         // object to the module
     PyModule_AddObject(
         m, "GmicException",
         (PyObject *)GmicException);  // Add Gmic object to the module
+    PyModule_AddObject(m, "GmicAborted",
+                       (PyObject *)GmicAborted);  // Add GmicAborted exception
+                                                  // to the module
     PyModule_AddObject(
         m, "__version__",
         PyUnicode_Join(PyUnicode_FromString("."),
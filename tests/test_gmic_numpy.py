@@ -1,4 +1,5 @@
 import os
+import struct
 
 import pytest
 import gmic
@@ -376,6 +377,264 @@ def test_fuzzy_1d_4d_random_gmic_matrices(
                     assert numpy_image[z, y, x, c] == gmic_image(x, y, z, c)
 
 
+@pytest.mark.parametrize("interleave", [False, True])
+def test_to_numpy_helper_without_copy(interleave):
+    gmic_image = gmic.GmicImage(None, 4, 3, 1, 2)
+    gmic.run("rand 0,1", gmic_image)
+    copied = gmic_image.to_numpy_helper(interleave=interleave)
+    view = gmic_image.to_numpy_helper(interleave=interleave, copy=False)
+    assert view.dtype == numpy.float32
+    assert view.shape == copied.shape
+    assert numpy.array_equal(view, copied)
+    assert view.flags.writeable
+    # Pixels are shared with the GmicImage, which the view keeps alive
+    view[...] = 3.0
+    assert gmic_image(1, 2, 0, 1) == 3.0
+    del gmic_image
+    assert numpy.all(view == 3.0)
+
+
+def test_to_numpy_without_copy_permute_and_astype():
+    gmic_image = gmic.GmicImage(None, 4, 3, 1, 2)
+    view = gmic_image.to_numpy_helper(
+        interleave=True, permute="zyxc", squeeze_shape=True, copy=False
+    )
+    assert view.shape == (3, 4, 2)
+    view[2, 1, 0] = 5.0
+    assert gmic_image(1, 2, 0, 0) == 5.0
+    # Casting cannot be done in place
+    cast = gmic_image.to_numpy_helper(astype=numpy.uint8, copy=False)
+    assert cast.dtype == numpy.uint8
+    assert not numpy.shares_memory(cast, view)
+    assert numpy.shares_memory(gmic_image.to_numpy(copy=False), view)
+    # A no-op astype keeps the view
+    same_type = gmic_image.to_numpy_helper(
+        astype=numpy.float32, interleave=True, copy=False
+    )
+    assert same_type.dtype == numpy.float32
+    assert numpy.shares_memory(same_type, view)
+    same_type[0, 0, 0, 1] = 9.0
+    assert gmic_image(0, 0, 0, 1) == 9.0
+
+
+def test_from_numpy_helper_without_copy_shares_planar_arrays():
+    planar = numpy.zeros((3, 4), dtype=numpy.float32)
+    gmic_image = gmic.GmicImage.from_numpy_helper(
+        planar, deinterleave=False, copy=False
+    )
+    assert gmic_image._is_shared
+    assert (gmic_image._width, gmic_image._height) == (4, 3)
+    planar[2, 1] = 7.0
+    assert gmic_image(1, 2) == 7.0
+    # Results of same-sized runs land in the array
+    gmic.run("add 1", gmic_image)
+    assert planar[2, 1] == 8.0 and planar[0, 0] == 1.0
+    # The GmicImage keeps the array alive
+    del planar
+    assert gmic_image(1, 2) == 8.0
+    # A reallocating run gives the GmicImage its own pixels
+    gmic.run("resize 200%,200%", gmic_image)
+    assert not gmic_image._is_shared
+    assert gmic_image._width == 8
+
+
+def test_from_numpy_without_copy_falls_back_to_copying():
+    # Interleaved channels, casts and read-only arrays cannot be shared
+    for array in (
+        numpy.zeros((3, 4, 3), dtype=numpy.float32),
+        numpy.zeros((3, 4), dtype=numpy.uint8),
+        numpy.zeros((3, 4), dtype=numpy.float32)[:, ::2],
+    ):
+        gmic_image = gmic.GmicImage.from_numpy(array, copy=False)
+        assert not gmic_image._is_shared
+    single_channel = numpy.zeros((3, 4, 1), dtype=numpy.float32)
+    assert gmic.GmicImage.from_numpy(single_channel, copy=False)._is_shared
+    read_only = numpy.zeros((3, 4), dtype=numpy.float32)
+    read_only.flags.writeable = False
+    assert not gmic.GmicImage.from_numpy(read_only, copy=False)._is_shared
+
+
+@pytest.mark.parametrize("spectrum", [1, 2, 3, 4, 5])
+@pytest.mark.parametrize("permute", ["xyzc", "zyxc", "yxzc"])
+def test_numpy_interleaving_conversions_match_pixels(spectrum, permute):
+    # Odd sizes exercise both vectorized and remaining pixels
+    gmic_image = gmic.GmicImage(None, 7, 5, 2, spectrum)
+    gmic.run("rand 0,255", gmic_image)
+    expected = numpy.empty((7, 5, 2, spectrum), dtype=numpy.float32)
+    for x in range(7):
+        for y in range(5):
+            for z in range(2):
+                for c in range(spectrum):
+                    expected[x, y, z, c] = gmic_image(x, y, z, c)
+    axes = ["xyzc".index(axis) for axis in permute]
+    numpy_image = gmic_image.to_numpy_helper(interleave=True, permute=permute)
+    assert numpy.array_equal(numpy_image, expected.transpose(axes))
+
+    single_slice = expected[:, :, 0, :].transpose(1, 0, 2)  # (y, x, c)
+    for array in (single_slice, single_slice.astype(numpy.uint8)):
+        round_trip = gmic.GmicImage.from_numpy(array)
+        assert numpy.array_equal(
+            round_trip.to_numpy_helper(interleave=True, permute="zyxc")[0],
+            array.astype(numpy.float32),
+        )
+
+
+@pytest.mark.parametrize(
+    "dtype",
+    [
+        numpy.bool_,
+        numpy.uint8,
+        numpy.uint16,
+        numpy.int16,
+        numpy.float64,
+        numpy.int64,
+    ],
+)
+@pytest.mark.parametrize("deinterleave", [False, True])
+def test_from_numpy_helper_casts_dtypes_while_copying(dtype, deinterleave):
+    array = numpy.arange(-50, 55).reshape((5, 7, 3)).astype(dtype)
+    expected = gmic.GmicImage.from_numpy_helper(
+        array.astype(numpy.float32), deinterleave=deinterleave
+    )
+    # Fortran-ordered matrices are not C-contiguous, thus go through float32
+    for source in (array, numpy.asfortranarray(array)):
+        gmic_image = gmic.GmicImage.from_numpy_helper(
+            source, deinterleave=deinterleave
+        )
+        assert_gmic_images_are_identical(gmic_image, expected)
+
+
+def test_to_numpy_helper_rounds_and_clamps_integer_dtypes():
+    gmic_image = gmic.GmicImage(
+        struct.pack("6f", -3.2, 0.4, 0.6, 254.5, 300.0, 1.0), 6, 1
+    )
+    assert gmic_image.to_numpy_helper(astype=numpy.uint8).ravel().tolist() == [
+        0,
+        0,
+        1,
+        255,
+        255,
+        1,
+    ]
+    assert gmic_image.to_numpy_helper(astype=numpy.int8).ravel().tolist() == [
+        -3,
+        0,
+        1,
+        127,
+        127,
+        1,
+    ]
+    assert gmic_image.to_numpy_helper(astype=bool).ravel().tolist() == [True] * 6
+    as_float64 = gmic_image.to_numpy_helper(astype=numpy.float64)
+    assert as_float64.dtype == numpy.float64
+    assert as_float64.flags.writeable
+    assert numpy.array_equal(as_float64, gmic_image.to_numpy_helper())
+
+
+@pytest.mark.parametrize("threads", ["1", "3"])
+def test_large_numpy_conversions_across_threads(threads, monkeypatch):
+    monkeypatch.setenv("GMIC_PY_CONVERSION_THREADS", threads)
+    # Above the million pixel values threading threshold
+    array = numpy.random.rand(601, 701, 3).astype(numpy.float32)
+    gmic_image = gmic.GmicImage.from_numpy(array)
+    assert gmic_image(700, 600, 0, 2) == array[600, 700, 2]
+    assert numpy.array_equal(
+        gmic_image.to_numpy_helper(interleave=True, permute="zyxc")[0], array
+    )
+    x_major = gmic_image.to_numpy_helper(interleave=True, astype=numpy.uint8)
+    assert numpy.array_equal(
+        x_major, numpy.rint(array.transpose(1, 0, 2)[:, :, None, :])
+    )
+
+    # Volumes are split across threads the same way, by slabs of slices
+    volume = numpy.random.rand(40, 101, 103, 3).astype(numpy.float32)
+    gmic_image = gmic.GmicImage.from_numpy_helper(volume, deinterleave=True)
+    assert gmic_image(102, 100, 39, 2) == volume.ravel()[-1]
+    assert numpy.array_equal(
+        gmic_image.to_numpy_helper(interleave=True).ravel(), volume.ravel()
+    )
+    # Packed (width, height, depth, spectrum) tensors take the same path
+    tensor = gmic_image.to_numpy_helper(interleave=True).transpose(2, 1, 0, 3)
+    assert_gmic_images_are_identical(gmic.GmicImage.from_dlpack(tensor), gmic_image)
+
+
+def test_numpy_from_dlpack_shares_gmic_image_pixels():
+    gmic_image = gmic.GmicImage(None, 4, 3, 2, 3)
+    gmic.run("rand 0,255", gmic_image)
+    assert gmic_image.__dlpack_device__() == (1, 0)
+    tensor = numpy.from_dlpack(gmic_image)
+    assert tensor.shape == (4, 3, 2, 3)
+    assert tensor[3, 2, 1, 2] == gmic_image(3, 2, 1, 2)
+    tensor[1, 2, 0, 1] = 1000.0
+    assert gmic_image(1, 2, 0, 1) == 1000.0
+    # The exported buffer stays in place during runs
+    gmic.run("add 1", gmic_image)
+    assert tensor[1, 2, 0, 1] == 1001.0
+    with pytest.raises(BufferError):
+        gmic.run("resize 200%,200%", gmic_image)
+    del tensor
+    gmic.run("resize 200%,200%", gmic_image)
+    assert gmic_image._width == 8
+
+
+def test_gmic_image_from_dlpack_shares_planar_float32_tensors():
+    planar = numpy.zeros((3, 4, 5), dtype=numpy.float32)  # (c, y, x)
+    gmic_image = gmic.GmicImage.from_dlpack(planar.T)
+    assert gmic_image._is_shared
+    assert (gmic_image._width, gmic_image._height, gmic_image._spectrum) == (
+        5,
+        4,
+        3,
+    )
+    planar[2, 1, 4] = 7.0
+    assert gmic_image(4, 1, 0, 2) == 7.0
+    gmic.run("add 1", gmic_image)
+    assert planar[2, 1, 4] == 8.0 and planar[0, 0, 0] == 1.0
+    del planar
+    assert gmic_image(4, 1, 0, 2) == 8.0
+    assert not gmic.GmicImage.from_dlpack(gmic_image, copy=True)._is_shared
+    assert_gmic_images_are_identical(
+        gmic.GmicImage.from_dlpack(gmic_image), gmic_image
+    )
+
+
+@pytest.mark.parametrize("dtype", [numpy.uint8, numpy.int16, numpy.float32])
+def test_gmic_image_from_dlpack_copies_other_tensors(dtype):
+    # (y, x, c) packed layout
+    packed = numpy.arange(5 * 4 * 3).reshape((5, 4, 3)).astype(dtype)
+    expected = gmic.GmicImage.from_numpy(packed)
+    for tensor in (packed.transpose(1, 0, 2), packed[:, ::2].transpose(1, 0, 2)):
+        gmic_image = gmic.GmicImage.from_dlpack(tensor)
+        assert not gmic_image._is_shared
+        assert gmic_image._width == tensor.shape[0]
+        for x in range(tensor.shape[0]):
+            for c in range(3):
+                assert gmic_image(x, 3, 0, c) == tensor[x, 3, c]
+    assert_gmic_images_are_identical(
+        gmic.GmicImage.from_dlpack(packed.transpose(1, 0, 2)), expected
+    )
+    with pytest.raises(gmic.GmicException):
+        gmic.GmicImage.from_dlpack(numpy.zeros((1, 1, 1, 1, 1), dtype=dtype))
+    with pytest.raises(TypeError):
+        gmic.GmicImage.from_dlpack(numpy.zeros((2, 2), dtype=numpy.complex64))
+
+
+@pytest.mark.parametrize("dtype", [numpy.float32, numpy.uint8])
+def test_from_numpy_helper_deinterleaves_volumes_in_baseline_order(dtype):
+    # Deinterleaved matrices of depth > 1 keep their items in (depth, height,
+    # width, spectrum) order, which to_numpy_helper(interleave=True) outputs
+    array = numpy.arange(5 * 7 * 3 * 2).reshape((5, 7, 3, 2)).astype(dtype)
+    gmic_image = gmic.GmicImage.from_numpy_helper(array, deinterleave=True)
+    assert (gmic_image._width, gmic_image._height) == (7, 5)
+    assert (gmic_image._depth, gmic_image._spectrum) == (3, 2)
+    items = array.ravel()
+    for x, y, z, c in ((0, 0, 1, 0), (6, 4, 2, 1), (3, 1, 0, 1)):
+        assert gmic_image(x, y, z, c) == items[((z * 5 + y) * 7 + x) * 2 + c]
+    round_trip = gmic_image.to_numpy_helper(interleave=True)
+    assert round_trip.shape == (3, 5, 7, 2)
+    assert numpy.array_equal(round_trip.ravel(), items.astype(numpy.float32))
+
+
 # Useful for some IDEs with debugging support
 if __name__ == "__main__":
     pytest.main([os.path.abspath(os.path.dirname(__file__))])
@@ -394,3 +394,42 @@ def test_toolkit_from_skimage(numpy_PIL_duck):
             numpy_PIL_duck, deinterleave=True, permute="zyxc"
         ),
     )
+
+
+@pytest.mark.parametrize(
+    "mode,astype",
+    [
+        ("L", numpy.uint8),
+        ("LA", numpy.uint8),
+        ("RGB", numpy.uint8),
+        ("RGBA", numpy.uint8),
+        ("I;16", numpy.uint16),
+        ("I", numpy.int32),
+        ("F", numpy.float32),
+    ],
+)
+def test_toolkit_PIL_raw_modes_round_trip(mode, astype):
+    import PIL.Image
+
+    spectrum = len(PIL.Image.new(mode, (1, 1)).getbands())
+    gmic_image = gmic.GmicImage(None, 7, 5, 1, spectrum)
+    gmic.run("rand 0,250 round", gmic_image)
+    pil_image = gmic_image.to_PIL(astype=astype, mode=mode)
+    assert pil_image.mode == mode
+    assert pil_image.size == (7, 5)
+    for c in range(spectrum):
+        pixel = pil_image.getpixel((6, 4))
+        pixel = pixel[c] if isinstance(pixel, tuple) else pixel
+        assert pixel == gmic_image(6, 4, 0, c)
+    assert_gmic_images_are_identical(gmic.GmicImage.from_PIL(pil_image), gmic_image)
+
+
+def test_toolkit_PIL_other_modes_go_through_numpy():
+    import PIL.Image
+
+    palette_image = PIL.Image.new("P", (3, 2), 7)
+    gmic_image = gmic.GmicImage.from_PIL(palette_image)
+    assert (gmic_image._width, gmic_image._height, gmic_image._spectrum) == (3, 2, 1)
+    assert gmic_image(2, 1) == 7
+    hsv_image = gmic.GmicImage(None, 3, 2, 1, 3).to_PIL(mode="HSV")
+    assert hsv_image.mode == "HSV"
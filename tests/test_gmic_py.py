@@ -1100,6 +1100,751 @@ def test_gmic_module_run_vs_single_instance_run_benchmark():
     )
 
 
+def test_gmic_run_releases_the_gil_for_other_python_threads():
+    import threading
+    import time
+
+    gmic_instance = gmic.Gmic()
+    counter = [0]
+    is_in_run = threading.Event()
+    has_aborted = threading.Event()
+
+    # Called with the GIL from the run's monitor thread, so only while G'MIC
+    # works
+    def on_progress(progress):
+        is_in_run.set()
+
+    # Works then stops the endless run, which only ends early if this thread
+    # gets the GIL while the native run is in progress
+    def work_then_abort():
+        is_in_run.wait()
+        work_end = time.monotonic() + 0.05
+        while time.monotonic() < work_end:
+            counter[0] += 1
+        has_aborted.set()
+        gmic_instance.abort()
+
+    working_thread = threading.Thread(target=work_then_abort)
+    working_thread.start()
+    start = time.monotonic()
+    with pytest.raises(gmic.GmicAborted):
+        gmic_instance.run("do noise 1 while 1", [gmic.GmicImage()], timeout=30, progress=on_progress)
+    elapsed = time.monotonic() - start
+    is_in_run.set()  # Unblock the thread if the run never reported progress
+    working_thread.join()
+
+    assert has_aborted.is_set()
+    assert counter[0] > 0
+    assert elapsed < 30  # Stopped by the other thread, not the timeout
+
+
+def test_gmic_instance_shared_by_several_threads():
+    import threading
+    import struct
+
+    gmic_instance = gmic.Gmic()
+    nb_threads = 8
+    results = [None] * nb_threads
+
+    def work(i):
+        image = gmic.GmicImage(struct.pack("4f", 1.0, 2.0, 3.0, 4.0), 2, 2)
+        gmic_instance.run("add {} resize 200%,200%".format(i), image)
+        results[i] = image
+
+    threads = [threading.Thread(target=work, args=(i,)) for i in range(nb_threads)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+    for i, image in enumerate(results):
+        assert (image._width, image._height) == (4, 4)
+        assert image(0, 0) == 1.0 + i
+
+
+@pytest.mark.parametrize(**gmic_instance_types)
+def test_gmic_images_list_run_without_copies_keeps_referenced_images(
+    gmic_instance_run,
+):
+    import struct
+
+    a = gmic.GmicImage(struct.pack("2f", 1.0, 2.0), 2, 1)
+    b = gmic.GmicImage(struct.pack("2f", 3.0, 4.0), 2, 1)
+    images = [a, b]
+    b_id = id(b)
+    del b
+    gmic_instance_run("add 1", images)
+    # Results go back into the GmicImage objects at their input position,
+    # taking over G'MIC's buffers, so that 'a' sees its result too
+    assert images[0] is a and id(images[1]) == b_id
+    assert (a(0, 0), a(1, 0)) == (2.0, 3.0)
+    assert (images[1](0, 0), images[1](1, 0)) == (4.0, 5.0)
+
+    # Chained runs on a list owning its images hand buffers over back and forth
+    gmic_instance_run("add 1 resize 200%,100%", images, move_inputs=True)
+    assert [(i._width, i._height) for i in images] == [(4, 1), (4, 1)]
+    assert images[0](0, 0) == 3.0
+
+
+def test_gmic_images_list_is_untouched_on_run_error():
+    import struct
+
+    def make_images():
+        return [gmic.GmicImage(struct.pack("2f", 1.0, 2.0), 2, 1), gmic.GmicImage(struct.pack("1f", 3.0))]
+
+    # Errors happening after commands that changed or removed images
+    for command in ("badly formatted command", "add 1 badly_formatted_command", "rm[0] badly_formatted_command"):
+        images = make_images()
+        items = list(images)
+        image_names = ["first", "second"]
+        with pytest.raises(gmic.GmicException):
+            gmic.run(command, images, image_names)
+        assert len(images) == 2 and all(i is j for i, j in zip(images, items))
+        assert image_names == ["first", "second"]
+        assert (images[0]._width, images[0]._height) == (2, 1)
+        assert (images[0](0, 0), images[0](1, 0), images[1](0)) == (1.0, 2.0, 3.0)
+
+    # Moved buffers cannot be restored, the list holds what G'MIC left
+    images = make_images()
+    with pytest.raises(gmic.GmicException):
+        gmic.run("add 1 rm[1] badly_formatted_command", images, move_inputs=True)
+    assert len(images) == 1
+    assert (images[0](0, 0), images[0](1, 0)) == (2.0, 3.0)
+
+
+def test_gmic_pool_submit_and_map():
+    import struct
+
+    with gmic.GmicPool(3) as pool:
+        assert pool.size == 3
+        assert "3 interpreters" in repr(pool)
+
+        images = []
+        future = pool.submit("sp apples", images)
+        assert future.result() is images
+        assert len(images) == 1 and images[0]._width > 0
+
+        images_sets = [
+            [gmic.GmicImage(struct.pack("2f", float(i), float(i)), 2, 1)]
+            for i in range(10)
+        ]
+        futures = pool.map("add 1 resize 200%,100%", images_sets)
+        assert len(futures) == 10
+        for i, future in enumerate(futures):
+            result = future.result()
+            assert result is images_sets[i]
+            assert (result[0]._width, result[0](3, 0)) == (4, i + 1.0)
+
+        # G'MIC errors are raised by the future
+        with pytest.raises(gmic.GmicException):
+            pool.submit("badly formatted command").result()
+
+
+def test_gmic_pool_bad_size():
+    with pytest.raises(ValueError):
+        gmic.GmicPool(-1)
+
+
+def test_gmic_run_async():
+    import asyncio
+    import struct
+    import time
+
+    async def main():
+        gmic_instance = gmic.Gmic()
+        images = []
+        result = await gmic_instance.run_async("sp apples blur 2", images)
+        assert result is images
+        assert len(images) == 1
+
+        # Several interpreters run concurrently from a same event loop
+        a = gmic.GmicImage(struct.pack("1f", 1.0))
+        b = gmic.GmicImage(struct.pack("1f", 2.0))
+        results = await asyncio.gather(
+            gmic_instance.run_async("add 1", a),
+            gmic.Gmic().run_async(images=b, command="mul 3"),
+        )
+        assert results == [a, b]
+        assert (a(0), b(0)) == (2.0, 6.0)
+
+        with pytest.raises(gmic.GmicException):
+            await gmic_instance.run_async("badly formatted command")
+
+        # Runs do not take the default executor's threads
+        asyncio.get_running_loop().run_in_executor = None
+        await gmic_instance.run_async("add 1", a)
+        assert a(0) == 3.0
+
+        # Cancelling a run aborts it
+        images = [gmic.GmicImage(struct.pack("1f", 1.0))]
+        start = time.monotonic()
+        with pytest.raises(asyncio.TimeoutError):
+            await asyncio.wait_for(
+                gmic_instance.run_async("do add 1 while 1", images, timeout=30), 0.5
+            )
+        # The aborted run releases the interpreter, and left images untouched
+        await gmic_instance.run_async("add 1", a, timeout=30)
+        assert time.monotonic() - start < 30
+        assert images[0](0) == 1.0
+
+    asyncio.run(main())
+
+
+def test_gmic_run_async_requires_running_loop():
+    with pytest.raises(RuntimeError):
+        gmic.Gmic().run_async("echo_stdout 'no loop'")
+
+
+def test_gmic_run_batch():
+    import struct
+
+    gmic_instance = gmic.Gmic()
+    images_sets = [[gmic.GmicImage(struct.pack("1f", float(i)))] for i in range(20)]
+    images_sets.append(gmic.GmicImage(struct.pack("1f", 100.0)))
+    results = gmic_instance.run_batch("add 1", images_sets, threads=4)
+    assert len(results) == len(images_sets)
+    assert all(r is s for r, s in zip(results, images_sets))
+    assert [s[0](0) for s in images_sets[:-1]] == [i + 1.0 for i in range(20)]
+    assert images_sets[-1](0) == 101.0
+
+    assert gmic_instance.run_batch("add 1", []) == []
+
+    # Results of all sets come back even if one of them fails
+    images_sets = [[gmic.GmicImage(struct.pack("1f", 1.0))], [], [gmic.GmicImage()]]
+    with pytest.raises(gmic.GmicException, match="Images set 1"):
+        gmic_instance.run_batch("rm[0]", images_sets)
+    assert images_sets == [[], [], []]
+
+    with pytest.raises(TypeError):
+        gmic_instance.run_batch("add 1", [[1]])
+    with pytest.raises(ValueError):
+        gmic_instance.run_batch("add 1", [], threads=-1)
+
+    # Each set's run gets its own memory budget, in parallel too
+    gmic_instance.max_memory = 64 * 1024 * 1024
+    images_sets = [[gmic.GmicImage(struct.pack("1f", 1.0))] for _ in range(4)]
+    gmic_instance.run_batch("add 1", images_sets, threads=2)
+    assert [s[0](0) for s in images_sets] == [2.0] * 4
+    with pytest.raises(gmic.GmicException, match="budget"):
+        gmic_instance.run_batch("repeat 64 +resize[0] 4096,4096,1,1 done", images_sets, threads=2)
+
+
+def test_gmic_run_timeout_and_abort():
+    import threading
+    import time
+
+    assert issubclass(gmic.GmicAborted, gmic.GmicException)
+    endless_command = "do noise 1 while 1"
+
+    gmic_instance = gmic.Gmic()
+    images = [gmic.GmicImage()]
+    start = time.monotonic()
+    with pytest.raises(gmic.GmicAborted, match="timed out"):
+        gmic_instance.run(endless_command, images, timeout=0.5)
+    assert time.monotonic() - start < 30
+    assert len(images) == 1
+
+    threading.Timer(0.5, gmic_instance.abort).start()
+    with pytest.raises(gmic.GmicAborted, match="aborted"):
+        gmic_instance.run(endless_command, images)
+
+    # The instance is still usable afterwards
+    gmic_instance.run("add 1", images, timeout=30)
+    gmic_instance.abort()  # No ongoing run, no effect
+    gmic_instance.run("add 1", images)
+
+    # Runs waiting for the interpreter are aborted too
+    is_in_run = threading.Event()
+    errors = []
+
+    def run_in_thread(progress=None):
+        try:
+            gmic_instance.run(endless_command, [gmic.GmicImage()], timeout=30, progress=progress)
+        except gmic.GmicAborted as e:
+            errors.append(str(e))
+
+    running = threading.Thread(target=run_in_thread, args=(lambda p: is_in_run.set(),))
+    running.start()
+    is_in_run.wait()
+    entered_runs = gmic_instance._entered_runs
+    waiting = threading.Thread(target=run_in_thread)
+    waiting.start()
+    while gmic_instance._entered_runs == entered_runs:
+        time.sleep(0.01)  # Until the second run waits for the interpreter
+    start = time.monotonic()
+    gmic_instance.abort()
+    running.join()
+    waiting.join()
+    assert time.monotonic() - start < 30
+    assert len(errors) == 2 and all("aborted" in e for e in errors)
+
+
+def test_gmic_run_progress():
+    import array
+
+    gmic_instance = gmic.Gmic()
+    values = []
+    gmic_instance.run("progress 50", progress=values.append)
+    assert len(values) >= 1
+    assert values[-1] == gmic_instance.progress
+
+    progress_buffer = array.array("f", [-2.0])
+    gmic_instance.run("progress 25", progress=progress_buffer)
+    assert progress_buffer[0] == gmic_instance.progress
+
+    def failing_callback(progress):
+        raise ValueError("stop there")
+
+    # A failing callback aborts the run and its exception is raised
+    with pytest.raises(ValueError, match="stop there"):
+        gmic_instance.run("do noise 1 while 1", [gmic.GmicImage()], progress=failing_callback)
+
+    with pytest.raises(TypeError):
+        gmic_instance.run("progress 50", progress="not a callback")
+    with pytest.raises(TypeError):
+        gmic_instance.run("progress 50", progress=array.array("d", [0.0]))
+
+
+def test_gmic_run_profile():
+    gmic_instance = gmic.Gmic()
+    assert gmic_instance.run("add 1", [gmic.GmicImage()]) is None
+
+    images = [gmic.GmicImage(), gmic.GmicImage()]
+    profile = gmic_instance.run("add 1 +blur 1", images, profile=True, move_inputs=True)
+    assert isinstance(profile, dict)
+    for key in ("total_seconds", "load_seconds", "lock_wait_seconds", "run_seconds", "store_seconds"):
+        assert profile[key] >= 0
+    assert profile["total_seconds"] >= profile["run_seconds"]
+    assert profile["input_images"] == 2
+    assert profile["moved_images"] == 2
+    assert profile["input_bytes"] == 2 * 4
+    assert profile["output_images"] == 4
+    assert profile["output_bytes"] == 4 * 4
+    assert profile["untouched_images"] == 0
+    assert profile["openmp_threads"] >= 1
+    assert profile["monitor_thread"] is False  # No timeout nor progress
+    assert profile["peak_rss_bytes"] >= profile["peak_rss_growth_bytes"] >= 0
+    assert profile["peak_memory_bytes"] >= 0
+
+
+def test_gmic_run_max_memory():
+    gmic_instance = gmic.Gmic()
+    assert gmic_instance.max_memory == 0
+
+    # Up to 4 GiB of float32 pixels, far above a 64 MiB budget
+    images = [gmic.GmicImage()]
+    with pytest.raises(gmic.GmicException, match="budget"):
+        gmic_instance.run("repeat 64 +resize[0] 4096,4096,1,1 done", images, max_memory=64 * 1024 * 1024)
+
+    gmic_instance.max_memory = 64 * 1024 * 1024
+    with pytest.raises(gmic.GmicException, match="budget"):
+        gmic_instance.run("repeat 64 +resize[0] 4096,4096,1,1 done", [gmic.GmicImage()])
+
+    # A small run fits, and reports its peak memory
+    profile = gmic_instance.run("resize 256,256", [gmic.GmicImage()], profile=True)
+    assert 0 <= profile["peak_memory_bytes"] <= 64 * 1024 * 1024
+    # A per-run value overrides the instance's one
+    gmic_instance.run("resize 256,256", [gmic.GmicImage()], max_memory=0)
+
+    with pytest.raises(ValueError):
+        gmic_instance.max_memory = -1
+    with pytest.raises(ValueError):
+        gmic_instance.run("add 1", max_memory=-1)
+
+
+def test_gmic_run_max_memory_with_runs_in_parallel():
+    import threading
+
+    # Each run is only charged for its own allocations, so a run going over
+    # its budget does not affect another one in progress
+    other_instance = gmic.Gmic()
+    is_in_run = threading.Event()
+    errors = []
+
+    def run_over_budget():
+        try:
+            other_instance.run(
+                "progress 0 repeat 64 +resize[0] 4096,4096,1,1 done",
+                [gmic.GmicImage()],
+                max_memory=64 * 1024 * 1024,
+                progress=lambda p: is_in_run.set(),
+            )
+        except gmic.GmicException as error:
+            errors.append(error)
+        finally:
+            is_in_run.set()
+
+    running = threading.Thread(target=run_over_budget)
+    running.start()
+    is_in_run.wait()
+    gmic.Gmic().run("resize 256,256", [gmic.GmicImage()], max_memory=64 * 1024 * 1024)
+    running.join()
+    assert len(errors) == 1 and "budget" in str(errors[0])
+
+    with gmic.GmicPool(2) as pool:
+        small = pool.submit("resize 256,256", [gmic.GmicImage()], max_memory=64 * 1024 * 1024)
+        large = pool.submit("repeat 64 +resize[0] 4096,4096,1,1 done", [gmic.GmicImage()], max_memory=64 * 1024 * 1024)
+        assert small.result()[0]._width == 256
+        with pytest.raises(gmic.GmicException, match="budget"):
+            large.result()
+
+
+def test_gmic_stream():
+    import struct
+
+    gmic_instance = gmic.Gmic()
+    frames = [gmic.GmicImage(struct.pack("1f", float(i))) for i in range(10)]
+    stream = gmic_instance.stream("add 1", frames)
+    assert iter(stream) is stream
+    assert [images[0](0) for images in stream] == [i + 1.0 for i in range(10)]
+    assert [f(0) for f in frames] == [float(i) for i in range(10)]  # Untouched inputs
+    assert list(stream) == []
+
+    # The same result objects come back each time
+    outputs = [images for images in gmic_instance.stream("add 1 +mul 2", iter(frames), reuse_output=True)]
+    assert all(o is outputs[0] for o in outputs)
+    assert len(outputs[0]) == 2
+    assert (outputs[0][0](0), outputs[0][1](0)) == (10.0, 20.0)
+
+    # Buffer frames are deinterleaved like GmicImage.from_numpy()
+    rgb_frame = bytearray([1, 2, 3, 4, 5, 6])
+    rgb_memoryview = memoryview(rgb_frame).cast("B", (1, 2, 3))
+    (images,) = list(gmic_instance.stream("add 1", [rgb_memoryview]))
+    assert (images[0]._width, images[0]._height, images[0]._spectrum) == (2, 1, 3)
+    assert [images[0](1, 0, 0, c) for c in range(3)] == [5.0, 6.0, 7.0]
+
+    # A bad frame raises once the former frame's result is yielded
+    stream = gmic_instance.stream("add 1", [frames[0], 42])
+    assert next(stream)[0](0) == 1.0
+    with pytest.raises(TypeError):
+        next(stream)
+
+    with pytest.raises(gmic.GmicException):
+        next(gmic_instance.stream("rm[1]", frames))
+
+    # Slot and result buffers are reused from frame to frame
+    large_frames = [gmic.GmicImage(None, 256, 256, 1, 3) for _ in range(12)]
+    addresses = set()
+    for images in gmic_instance.stream("add 1", large_frames, reuse_output=True):
+        addresses.add(re.search(r"_data address at (\w+)", repr(images[0])).group(1))
+    assert len(addresses) <= 3  # Two slots and the result
+
+
+def test_gmic_image_buffer_protocol():
+    import struct
+
+    image = gmic.GmicImage(struct.pack("6f", *range(6)), 3, 2)
+    view = memoryview(image)
+    assert view.format == "f"
+    assert view.shape == (3, 2, 1, 1)
+    assert view.strides == (4, 12, 24, 24)
+    assert view.f_contiguous
+    assert view[2, 1, 0, 0] == image(2, 1) == 5.0
+    view[2, 1, 0, 0] = 10.0  # Writes into the image, without copies
+    assert image(2, 1) == 10.0
+    assert view.tobytes("A") == image._data  # Planar memory order
+
+    # Same-sized results are copied into an exported buffer
+    gmic.run("add 1", image)
+    assert view[2, 1, 0, 0] == 11.0
+    # but an exported buffer cannot be resized
+    with pytest.raises(BufferError):
+        gmic.run("resize 200%,200%", image)
+    assert (image._width, image._height, image(2, 1)) == (3, 2, 11.0)
+
+    # Exported images in a list are copied, not moved
+    images = [image]
+    gmic.run("resize 200%,200%", images)
+    assert images[0] is not image
+    assert (images[0]._width, image._width) == (6, 3)
+
+    view.release()
+    gmic.run("resize 200%,200%", image)
+    assert image._width == 6
+
+    # Images with a single non-flat dimension are C-contiguous too
+    assert not memoryview(image).c_contiguous
+    assert memoryview(gmic.GmicImage(struct.pack("3f", 1, 2, 3), 3, 1)).c_contiguous
+
+
+def test_gmic_image_buffer_protocol_numpy():
+    numpy = pytest.importorskip("numpy")
+    image = gmic.GmicImage(None, 4, 3, 1, 2)
+    array = numpy.asarray(image)
+    assert array.shape == (4, 3, 1, 2)
+    assert array.dtype == numpy.float32
+    array[1, 2, 0, 1] = 7.0
+    assert image(1, 2, 0, 1) == 7.0
+
+
+def test_gmic_image_gather():
+    import struct
+
+    image = gmic.GmicImage(struct.pack("12f", *range(12)), 3, 2, 1, 2)
+    values = image.gather([(2, 1), (0, 0)])
+    assert values.format == "f" and values.shape == (2, 2)
+    assert values.tolist() == [[5.0, 11.0], [0.0, 6.0]]
+    # Points with a channel coordinate get a single value each
+    assert image.gather([(1, 1, 0, 1), (2, 0, 0, 0)]).tolist() == [10.0, 2.0]
+    assert image.gather([0, 1]).tolist() == [[0.0, 6.0], [1.0, 7.0]]
+    assert image.gather([]).tolist() == []
+
+    assert image.gather([(0.5, 0.5, 0, 0)], "linear").tolist() == [2.0]
+    assert image.gather([(1, 1, 0, 0)], "cubic").tolist() == [image(1, 1)]
+    # Out of bounds points are clamped, or get out_value
+    assert image.gather([(10, -3, 0, 0)]).tolist() == [2.0]
+    assert image.gather([(10, -3, 0, 0)], out_value=-1).tolist() == [-1.0]
+
+    with pytest.raises(gmic.GmicException, match=".*interpolation.*"):
+        image.gather([(0, 0)], "bicubic")
+    with pytest.raises(gmic.GmicException):
+        image.gather([(0, 0, 0, 0, 0)])
+    with pytest.raises(TypeError):
+        image.gather([(0, 0), (0,)])
+
+
+def test_gmic_image_scatter():
+    image = gmic.GmicImage(None, 3, 2, 1, 2)
+    image.scatter([(0, 0), (2, 1), (5, 5)], [7, 8, 9])
+    assert (image(0, 0, 0, 1), image(2, 1, 0, 0), image(1, 1)) == (7, 8, 0)
+    image.scatter([(1, 0, 0, 1)], 3)
+    assert (image(1, 0, 0, 0), image(1, 0, 0, 1)) == (0, 3)
+    image.scatter([(1, 1)], [(4, 5)])
+    assert (image(1, 1, 0, 0), image(1, 1, 0, 1)) == (4, 5)
+    # Linear scattering spreads values over neighbouring pixels
+    image.scatter([(1.5, 1, 0, 0)], 2, "linear")
+    assert (image(1, 1), image(2, 1)) == (3, 5)
+
+    with pytest.raises(gmic.GmicException, match=".*interpolation.*"):
+        image.scatter([(0, 0)], 1, "cubic")
+    with pytest.raises(gmic.GmicException, match=".*values.*"):
+        image.scatter([(0, 0), (1, 1)], [1, 2, 3])
+
+
+def test_gmic_image_gather_and_scatter_numpy():
+    numpy = pytest.importorskip("numpy")
+    image = gmic.GmicImage(None, 64, 48, 1, 3)
+    gmic.run("rand 0,255", image)
+    array = numpy.asarray(image)
+    coords = numpy.stack(
+        [numpy.random.randint(0, 64, 500), numpy.random.randint(0, 48, 500)], 1
+    )
+    values = numpy.asarray(image.gather(coords))
+    assert values.shape == (500, 3)
+    assert numpy.array_equal(values, array[coords[:, 0], coords[:, 1], 0, :])
+    float_coords = coords.astype(numpy.float64) + 0.25
+    assert numpy.array_equal(image.gather(float_coords), values)
+
+    image.scatter(coords, -values)
+    assert numpy.array_equal(array[coords[:, 0], coords[:, 1], 0, :], -values)
+
+
+def test_gmic_image_subscript_views_and_copies():
+    import struct
+
+    image = gmic.GmicImage(struct.pack("24f", *range(24)), 3, 2, 2, 2)
+    channel = image[:, :, :, 1]
+    assert channel._is_shared
+    assert (channel._width, channel._height, channel._depth, channel._spectrum) == (
+        3,
+        2,
+        2,
+        1,
+    )
+    assert channel(2, 1, 1) == image(2, 1, 1, 1) == 23
+    line = image[1:, 1, 0, 0]
+    assert line._is_shared and line._width == 2 and line(0) == image(1, 1) == 4
+    assert image[-1, -1, -1, -1](0) == 23
+    # Runs on views write into the parent image
+    gmic.run("mul 2", channel)
+    assert image(2, 1, 1, 1) == 46 and image(2, 1, 1, 0) == 11
+    # which cannot change dimensions while views live
+    with pytest.raises(BufferError):
+        gmic.run("resize 200%,200%", image)
+    del channel, line
+    images = [image[:, :, 0]]
+    gmic.run("resize 200%,200%", images)
+    assert images[0]._width == 6 and image._width == 3
+
+    # Non-contiguous regions are copies, written back through assignment
+    region = image[1:3, 0:2, 1]
+    assert not region._is_shared
+    assert (region._width, region._height, region._spectrum) == (2, 2, 2)
+    assert region(1, 1, 0, 1) == image(2, 1, 1, 1)
+    gmic.run("fill 0", region)
+    assert image(2, 1, 1, 1) != 0
+    image[1:3, 0:2, 1] = region
+    assert image(2, 1, 1, 1) == 0 and image(0, 1, 1, 1) != 0
+    image[0, :, :, 0] = -1
+    assert image(0, 1, 1, 0) == -1 and image(1, 1, 1, 0) != -1
+
+    with pytest.raises(IndexError):
+        image[3]
+    with pytest.raises(IndexError):
+        image[1:1]
+    with pytest.raises(IndexError):
+        image[0, 0, 0, 0, 0]
+    with pytest.raises(ValueError):
+        image[::2]
+    with pytest.raises(ValueError):
+        image[0:2] = region
+
+
+def test_gmic_images_list_run_keeps_image_identities():
+    import struct
+
+    a = gmic.GmicImage(struct.pack("2f", 1.0, 2.0), 2, 1)
+    view = memoryview(a)
+    images = [a, a]
+    gmic.run("add 1 resize[0] 1,1 +add[1] 1", images)
+    # An image repeated in the list gets its first result only, and its
+    # exported buffer cannot fit a resized one
+    assert len(images) == 3
+    assert images[0] is not a and images[0]._width == 1
+    assert images[1] is a and images[2] is not a
+    assert (view[0, 0, 0, 0], a(1, 0), images[2](1, 0)) == (2.0, 3.0, 4.0)
+
+    # Removed images shrink the list, which stays the same object
+    images_list = images
+    gmic.run("rm[0,1]", images)
+    assert images is images_list and len(images) == 1
+
+
+def test_gmic_session():
+    import struct
+
+    gmic_instance = gmic.Gmic()
+    image = gmic.GmicImage(struct.pack("4f", 1, 2, 3, 4), 2, 2)
+    session = gmic_instance.session(image, ["first"])
+    assert isinstance(session, gmic.GmicSession)
+    assert len(session) == 1
+    assert session.names == ["first"]
+
+    # Images stay resident across runs, inputs untouched
+    session.run("add 1")
+    session.run("mul 2")
+    assert image(0, 0) == 1.0
+    fetched = session.fetch()
+    assert [fetched(x, y) for y in range(2) for x in range(2)] == [4.0, 6.0, 8.0, 10.0]
+    assert len(session) == 1  # fetch() copies
+
+    # Commands may add images, pushed images may be named
+    session.push(gmic.GmicImage(struct.pack("1f", 5.0)), "second")
+    session.run("+add[-1] 1")
+    assert len(session) == 3
+    assert session.names[:2] == ["first", "second"]
+    assert session.fetch(-1)(0) == 6.0
+    assert session.run("sub[1] 1") is None
+    assert session.fetch(1)(0) == 4.0
+
+    # pop() moves images out of the session
+    popped = session.pop(0)
+    assert (popped._width, popped._height) == (2, 2)
+    assert popped(1, 1) == 10.0
+    assert session.names[0] == "second"
+
+    with pytest.raises(IndexError):
+        session.fetch(2)
+    with pytest.raises(gmic.GmicException):
+        session.run("unknown_command_for_sure")
+    with pytest.raises(TypeError):
+        gmic_instance.session([42])
+
+    session.clear()
+    assert len(session) == 0
+    with pytest.raises(IndexError):
+        session.pop()
+
+
+def test_gmic_run_outputs_selection():
+    import struct
+
+    gmic_instance = gmic.Gmic()
+    a = gmic.GmicImage(struct.pack("1f", 1.0))
+    b = gmic.GmicImage(struct.pack("1f", 2.0))
+
+    # Only the last result comes back, into the GmicImage at its position
+    images = [a, b]
+    image_names = ["a", "b"]
+    gmic_instance.run("+add 10", images, image_names, outputs=-1)
+    assert len(images) == 1
+    assert images[0](0) == 12.0
+    assert len(image_names) == 1
+
+    images = [a, b]
+    gmic_instance.run("+add 10", images, outputs=[0, -1])
+    assert [i(0) for i in images] == [1.0, 12.0]
+    assert images[0] is a
+
+    # G'MIC-like selection strings
+    images = [gmic.GmicImage(struct.pack("1f", float(i))) for i in range(5)]
+    gmic_instance.run("add 1", images, outputs="[0-2,-1]")
+    assert [i(0) for i in images] == [1.0, 2.0, 3.0, 5.0]
+    gmic_instance.run("add 1", images, outputs=[])
+    assert images == []
+
+    # Bad selections
+    with pytest.raises(gmic.GmicException):
+        gmic_instance.run("add 1", [a], outputs="[0,x]")
+    with pytest.raises(TypeError):
+        gmic_instance.run("add 1", [a], outputs=1.5)
+    images = [gmic.GmicImage(struct.pack("1f", 1.0))]
+    with pytest.raises(IndexError):
+        gmic_instance.run("add 1", images, outputs=[3])
+    assert len(images) == 1 and images[0](0) == 2.0  # All images come back
+
+
+def test_gmic_run_skips_untouched_inputs():
+    import struct
+
+    gmic_instance = gmic.Gmic()
+    reference = gmic.GmicImage(struct.pack("2f", 1.0, 2.0), 2, 1)
+    reference_view = memoryview(reference)  # Copied into G'MIC, not moved
+    images = [reference, gmic.GmicImage(struct.pack("2f", 3.0, 4.0), 2, 1)]
+
+    # A read-only input is not copied back into its exported buffer
+    profile = gmic_instance.run("add[1] [0]", images, profile=True)
+    assert profile["untouched_images"] == 1
+    assert images[0] is reference
+    assert (images[1](0, 0), images[1](1, 0)) == (4.0, 6.0)
+
+    # Inputs changed in place are still copied back
+    profile = gmic_instance.run("add 1", images, profile=True)
+    assert profile["untouched_images"] == 0
+    assert reference_view.cast("B").cast("f").tolist() == [2.0, 3.0]
+    reference_view.release()
+
+    # Large read-only inputs are skipped too, and written ones copied back
+    large = gmic.GmicImage(None, 2048, 2048)
+    large_view = memoryview(large)
+    images = [large, gmic.GmicImage(None, 2048, 2048)]
+    profile = gmic_instance.run("add[1] [0]", images, profile=True)
+    assert profile["untouched_images"] == 1
+    assert images[0] is large
+    profile = gmic_instance.run("fill[0] 1", images, profile=True)
+    assert profile["untouched_images"] == 0
+    assert large_view[0, 0, 0, 0] == large_view[2047, 2047, 0, 0] == 1.0
+    large_view.release()
+
+
+def test_gmic_instances_keep_own_user_commands():
+    # Commands files are read from disk once per process and parsed by each
+    # interpreter, while commands added by runs stay with their interpreter
+    interpreters = [gmic.Gmic() for _ in range(8)]
+    for interpreter in interpreters:
+        images = []
+        interpreter.run("input 4,4,1,3 to_gray", images)
+        assert images[0]._spectrum == 1
+
+    interpreters[0].run('m "gmicpy_own_command : input 1,1,1,1,42"')
+    images = []
+    interpreters[0].run("gmicpy_own_command", images)
+    assert images[0](0) == 42.0
+    for interpreter in (interpreters[1], gmic.Gmic()):
+        with pytest.raises(gmic.GmicException, match=".*gmicpy_own_command.*"):
+            interpreter.run("gmicpy_own_command", [])
+
+
 # Useful for some IDEs with debugging support
 if __name__ == "__main__":
     pytest.main([os.path.abspath(os.path.dirname(__file__))])